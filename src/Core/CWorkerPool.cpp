@@ -0,0 +1,125 @@
+#include "CWorkerPool.h"
+#include <Common/Macros.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+CWorkerPool::CWorkerPool(uint32 NumThreads /*= 0*/)
+    : mShuttingDown(false)
+{
+    if (NumThreads == 0)
+    {
+        NumThreads = std::thread::hardware_concurrency();
+
+        if (NumThreads == 0)
+            NumThreads = 1;
+    }
+
+    mThreads.reserve(NumThreads);
+
+    for (uint32 ThreadIdx = 0; ThreadIdx < NumThreads; ThreadIdx++)
+        mThreads.emplace_back(&CWorkerPool::WorkerMain, this);
+}
+
+CWorkerPool::~CWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> Lock(mJobMutex);
+        mShuttingDown = true;
+    }
+    mJobAvailable.notify_all();
+
+    for (uint32 ThreadIdx = 0; ThreadIdx < mThreads.size(); ThreadIdx++)
+        mThreads[ThreadIdx].join();
+}
+
+void CWorkerPool::WorkerMain()
+{
+    while (true)
+    {
+        std::function<void()> Job;
+
+        {
+            std::unique_lock<std::mutex> Lock(mJobMutex);
+            mJobAvailable.wait(Lock, [this]() { return mShuttingDown || !mJobs.empty(); });
+
+            // Finish any queued jobs before shutting down
+            if (mJobs.empty())
+                return;
+
+            Job = std::move(mJobs.front());
+            mJobs.pop_front();
+        }
+
+        Job();
+    }
+}
+
+void CWorkerPool::AddJob(std::function<void()> Job)
+{
+    {
+        std::lock_guard<std::mutex> Lock(mJobMutex);
+        ASSERT(!mShuttingDown);
+        mJobs.push_back(std::move(Job));
+    }
+    mJobAvailable.notify_one();
+}
+
+void CWorkerPool::ParallelFor(uint32 Count, const std::function<void(uint32)>& kFunc)
+{
+    if (Count == 0)
+        return;
+
+    // Work is handed out one index at a time from a shared counter. Helper jobs may not get to run
+    // until after all the work is done (e.g. if the pool is busy), so the shared state is reference
+    // counted and we only wait for the work itself to finish, not for the helper jobs.
+    struct SSharedState
+    {
+        std::function<void(uint32)> Func;
+        uint32 Count;
+        std::atomic<uint32> NextIndex;
+        std::atomic<uint32> NumFinished;
+        std::mutex Mutex;
+        std::condition_variable Finished;
+    };
+
+    std::shared_ptr<SSharedState> pState = std::make_shared<SSharedState>();
+    pState->Func = kFunc;
+    pState->Count = Count;
+    pState->NextIndex = 0;
+    pState->NumFinished = 0;
+
+    auto RunWork = [](SSharedState* pInState)
+    {
+        uint32 Index;
+
+        while ((Index = pInState->NextIndex.fetch_add(1)) < pInState->Count)
+        {
+            pInState->Func(Index);
+
+            if (pInState->NumFinished.fetch_add(1) + 1 == pInState->Count)
+            {
+                std::lock_guard<std::mutex> Lock(pInState->Mutex);
+                pInState->Finished.notify_all();
+            }
+        }
+    };
+
+    uint32 NumHelpers = std::min<uint32>(NumThreads(), Count - 1);
+
+    for (uint32 HelperIdx = 0; HelperIdx < NumHelpers; HelperIdx++)
+    {
+        AddJob([pState, RunWork]() { RunWork(pState.get()); });
+    }
+
+    RunWork(pState.get());
+
+    std::unique_lock<std::mutex> Lock(pState->Mutex);
+    pState->Finished.wait(Lock, [&pState]() { return pState->NumFinished == pState->Count; });
+}
+
+CWorkerPool* CWorkerPool::Shared()
+{
+    static CWorkerPool sSharedPool;
+    return &sSharedPool;
+}
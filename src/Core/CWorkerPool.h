@@ -0,0 +1,47 @@
+#ifndef CWORKERPOOL_H
+#define CWORKERPOOL_H
+
+#include <Common/BasicTypes.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** Fixed-size pool of worker threads for running independent jobs in parallel.
+ *  Jobs shouldn't touch anything that isn't thread-safe; in practice, that means file I/O and
+ *  processing of data that isn't shared. Anything that touches game templates, the resource
+ *  store, or OpenGL still needs to happen on the thread that owns it.
+ */
+class CWorkerPool
+{
+    std::vector<std::thread> mThreads;
+    std::deque< std::function<void()> > mJobs;
+    std::mutex mJobMutex;
+    std::condition_variable mJobAvailable;
+    bool mShuttingDown;
+
+    void WorkerMain();
+
+public:
+    /** Constructor. If NumThreads is 0, one thread is created per hardware thread. */
+    explicit CWorkerPool(uint32 NumThreads = 0);
+    ~CWorkerPool();
+
+    /** Queue a job to run on one of the worker threads */
+    void AddJob(std::function<void()> Job);
+
+    /** Run kFunc(Index) for every index in [0, Count) in parallel and wait for all of them to finish.
+     *  The calling thread helps out while it waits, so this is safe to call from inside a job.
+     */
+    void ParallelFor(uint32 Count, const std::function<void(uint32)>& kFunc);
+
+    /** Accessors */
+    inline uint32 NumThreads() const    { return mThreads.size(); }
+
+    /** Shared pool used across the editor. Created the first time it's requested. */
+    static CWorkerPool* Shared();
+};
+
+#endif // CWORKERPOOL_H
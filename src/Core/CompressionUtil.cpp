@@ -1,5 +1,7 @@
 #include "CompressionUtil.h"
+#include "Core/CWorkerPool.h"
 #include <Common/Common.h>
+#include <algorithm>
 
 #if USE_LZOKAY
 #include <lzokay.hpp>
@@ -11,6 +13,12 @@
 
 namespace CompressionUtil
 {
+    /** Size of each segment in the segmented format; only the last segment may be smaller */
+    const uint32 gkSegmentSize = 0x4000;
+
+    /** Number of segments handed to the worker pool at a time when compressing */
+    const uint32 gkSegmentsPerBatch = 64;
+
     const char* ErrorText_zlib(int32 Error)
     {
         switch (Error)
@@ -66,33 +74,165 @@ namespace CompressionUtil
     }
 #endif
 
-    // ************ DECOMPRESS ************
-    bool DecompressZlib(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut)
+#if !USE_LZOKAY
+    bool InitLZO()
+    {
+        // lzo_init only needs to run once per process
+        static const bool skInitialized = (lzo_init() == LZO_E_OK);
+        return skInitialized;
+    }
+#endif
+
+    int32 ZlibLevel(ECookProfile Profile)
     {
-        // Initialize z_stream
-        z_stream z;
-        z.zalloc = Z_NULL;
-        z.zfree = Z_NULL;
-        z.opaque = Z_NULL;
-        z.avail_in = SrcLen;
-        z.next_in = pSrc;
-        z.avail_out = DstLen;
-        z.next_out = pDst;
+        switch (Profile)
+        {
+        case ECookProfile::Fast:        return Z_BEST_SPEED;
+        case ECookProfile::Balanced:    return 6;
+        default:                        return Z_BEST_COMPRESSION;
+        }
+    }
 
-        // Attempt decompress
-        int32 Error = inflateInit(&z);
+    // ************ CONTEXT ************
+    struct CCompressionContext::SCodecState
+    {
+        z_stream Inflate;
+        z_stream Deflate;
+        bool InflateReady;
+        bool DeflateReady;
+        int32 DeflateLevel;
+
+#if USE_LZOKAY
+        lzokay::Dict<> LZODict;
+#else
+        std::vector<uint8> LZOWorkMem;
+#endif
+    };
+
+    CCompressionContext::CCompressionContext()
+        : mpState(new SCodecState)
+    {
+        memset(&mpState->Inflate, 0, sizeof(z_stream));
+        memset(&mpState->Deflate, 0, sizeof(z_stream));
+        mpState->InflateReady = false;
+        mpState->DeflateReady = false;
+        mpState->DeflateLevel = Z_DEFAULT_COMPRESSION;
+    }
+
+    CCompressionContext::~CCompressionContext()
+    {
+        if (mpState->InflateReady) inflateEnd(&mpState->Inflate);
+        if (mpState->DeflateReady) deflateEnd(&mpState->Deflate);
+        delete mpState;
+    }
 
+    bool CCompressionContext::DecompressZlib(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut, bool LogErrors /*= true*/)
+    {
+        // Initialize z_stream the first time through; after that, just reset it
+        z_stream& z = mpState->Inflate;
+        int32 Error;
+
+        if (!mpState->InflateReady)
+        {
+            Error = inflateInit(&z);
+            mpState->InflateReady = (Error == Z_OK);
+        }
+        else
+            Error = inflateReset(&z);
+
+        // Attempt decompress
         if (!Error)
         {
+            z.avail_in = SrcLen;
+            z.next_in = pSrc;
+            z.avail_out = DstLen;
+            z.next_out = pDst;
+
             Error = inflate(&z, Z_NO_FLUSH);
+            rTotalOut = z.total_out;
+        }
 
-            if (!Error || Error == Z_STREAM_END)
-                Error = inflateEnd(&z);
+        // Check for errors
+        if (Error && Error != Z_STREAM_END)
+        {
+            if (LogErrors) errorf("zlib error: %s", ErrorText_zlib(Error));
+            return false;
+        }
+
+        else return true;
+    }
+
+    bool CCompressionContext::DecompressLZO(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut, bool LogErrors /*= true*/)
+    {
+#if USE_LZOKAY
+        // Destination capacity goes in, decompressed size comes out
+        size_t TotalOut = DstLen;
+        lzokay::EResult Result = lzokay::decompress(pSrc, (size_t) SrcLen, pDst, TotalOut);
+
+        if (Result < lzokay::EResult::Success)
+        {
+            if (LogErrors) errorf("LZO error: %s", ErrorText_LZO(Result));
+            return false;
+        }
+#else
+        InitLZO();
+        lzo_uint TotalOut = DstLen;
+        int32 Error = lzo1x_decompress_safe(pSrc, SrcLen, pDst, &TotalOut, LZO1X_MEM_DECOMPRESS);
+
+        if (Error)
+        {
+            if (LogErrors) errorf("LZO error: %s", ErrorText_LZO(Error));
+            return false;
+        }
+#endif
+
+        if (TotalOut > DstLen)
+        {
+            if (LogErrors) errorf("LZO error: decompressed data overflowed the output buffer");
+            return false;
+        }
+
+        rTotalOut = (uint32) TotalOut;
+        return true;
+    }
+
+    bool CCompressionContext::CompressZlib(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut, ECookProfile Profile /*= ECookProfile::Max*/)
+    {
+        z_stream& z = mpState->Deflate;
+        int32 Level = ZlibLevel(Profile);
+        int32 Error;
+
+        if (!mpState->DeflateReady)
+        {
+            Error = deflateInit(&z, Level);
+            mpState->DeflateReady = (Error == Z_OK);
+        }
+        else
+        {
+            Error = deflateReset(&z);
+
+            // Changing parameters on a freshly reset stream doesn't flush any output
+            if (!Error && Level != mpState->DeflateLevel)
+                Error = deflateParams(&z, Level, Z_DEFAULT_STRATEGY);
+        }
+
+        if (!Error)
+            mpState->DeflateLevel = Level;
+
+        if (!Error)
+        {
+            z.avail_in = SrcLen;
+            z.next_in = pSrc;
+            z.avail_out = DstLen;
+            z.next_out = pDst;
+
+            // Anything other than Z_STREAM_END means the output buffer was too small
+            Error = deflate(&z, Z_FINISH);
+            if (Error == Z_OK) Error = Z_BUF_ERROR;
 
             rTotalOut = z.total_out;
         }
 
-        // Check for errors
         if (Error && Error != Z_STREAM_END)
         {
             errorf("zlib error: %s", ErrorText_zlib(Error));
@@ -102,10 +242,14 @@ namespace CompressionUtil
         else return true;
     }
 
-    bool DecompressLZO(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32& rTotalOut)
+    bool CCompressionContext::CompressLZO(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut, ECookProfile Profile /*= ECookProfile::Max*/)
     {
 #if USE_LZOKAY
-        lzokay::EResult Result = lzokay::decompress(pSrc, (size_t) SrcLen, pDst, (size_t&) rTotalOut);
+        // lzokay only has one compression level, so the profile has no effect here
+        (void) Profile;
+        size_t TotalOut = 0;
+        lzokay::EResult Result = lzokay::compress(pSrc, (size_t) SrcLen, pDst, (size_t) DstLen, TotalOut, mpState->LZODict);
+        rTotalOut = (uint32) TotalOut;
 
         if (Result < lzokay::EResult::Success)
         {
@@ -115,9 +259,20 @@ namespace CompressionUtil
 
         return true;
 #else
-        lzo_init();
+        InitLZO();
+
+        // Allocate enough work memory for either compressor
+        if (mpState->LZOWorkMem.empty())
+            mpState->LZOWorkMem.resize(std::max<uint32>(LZO1X_1_MEM_COMPRESS, LZO1X_999_MEM_COMPRESS));
+
         lzo_uint TotalOut;
-        int32 Error = lzo1x_decompress(pSrc, SrcLen, pDst, &TotalOut, LZO1X_MEM_DECOMPRESS);
+        int32 Error;
+
+        if (Profile == ECookProfile::Max)
+            Error = lzo1x_999_compress(pSrc, SrcLen, pDst, &TotalOut, mpState->LZOWorkMem.data());
+        else
+            Error = lzo1x_1_compress(pSrc, SrcLen, pDst, &TotalOut, mpState->LZOWorkMem.data());
+
         rTotalOut = (uint32) TotalOut;
 
         if (Error)
@@ -130,7 +285,41 @@ namespace CompressionUtil
 #endif
     }
 
-    bool DecompressSegmentedData(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen)
+    CCompressionContext& CCompressionContext::ThreadContext()
+    {
+        static thread_local CCompressionContext sContext;
+        return sContext;
+    }
+
+    // ************ DECOMPRESS ************
+    bool DecompressZlib(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut)
+    {
+        return CCompressionContext::ThreadContext().DecompressZlib(pSrc, SrcLen, pDst, DstLen, rTotalOut);
+    }
+
+    bool DecompressLZO(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut)
+    {
+        return CCompressionContext::ThreadContext().DecompressLZO(pSrc, SrcLen, pDst, DstLen, rTotalOut);
+    }
+
+    bool DecompressSegment(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut, bool LogErrors /*= true*/)
+    {
+        CCompressionContext& rContext = CCompressionContext::ThreadContext();
+
+        // Check for zlib magic
+        uint8 ByteC = pSrc[0];
+        uint8 ByteD = pSrc[1];
+        uint16 PeekMagic = (ByteC << 8) | ByteD;
+
+        if (PeekMagic == 0x78DA || PeekMagic == 0x789C || PeekMagic == 0x7801)
+            return rContext.DecompressZlib(pSrc, SrcLen, pDst, DstLen, rTotalOut, LogErrors);
+
+        // No zlib magic - this is LZO
+        else
+            return rContext.DecompressLZO(pSrc, SrcLen, pDst, DstLen, rTotalOut, LogErrors);
+    }
+
+    bool DecompressSegmentedDataSequential(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen)
     {
         uint8 *pSrcEnd = pSrc + SrcLen;
         uint8 *pDstEnd = pDst + DstLen;
@@ -156,23 +345,8 @@ namespace CompressionUtil
             // If size is positive then we have compressed data.
             else
             {
-                // Check for zlib magic
-                uint8 ByteC = pSrc[0];
-                uint8 ByteD = pSrc[1];
-                uint16 PeekMagic = (ByteC << 8) | ByteD;
-
-                if (PeekMagic == 0x78DA || PeekMagic == 0x789C || PeekMagic == 0x7801)
-                {
-                    bool Success = DecompressZlib(pSrc, Size, pDst, (uint32) (pDstEnd - pDst), TotalOut);
-                    if (!Success) return false;
-                }
-
-                // No zlib magic - this is LZO
-                else
-                {
-                    bool Success = DecompressLZO(pSrc, Size, pDst, TotalOut);
-                    if (!Success) return false;
-                }
+                bool Success = DecompressSegment(pSrc, Size, pDst, (uint32) (pDstEnd - pDst), TotalOut);
+                if (!Success) return false;
 
                 pSrc += Size;
                 pDst += TotalOut;
@@ -182,127 +356,213 @@ namespace CompressionUtil
         return ((pSrc == pSrcEnd) && (pDst == pDstEnd));
     }
 
-    // ************ COMPRESS ************
-    bool CompressZlib(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut)
+    bool DecompressSegmentedData(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen)
     {
-        z_stream z;
-        z.zalloc = Z_NULL;
-        z.zfree = Z_NULL;
-        z.opaque = Z_NULL;
-        z.avail_in = SrcLen;
-        z.next_in = pSrc;
-        z.avail_out = DstLen;
-        z.next_out = pDst;
+        // Segments are compressed independently, so they can be decompressed in parallel as long as
+        // we know where each one goes. Scan the segment headers first. Every segment but the last
+        // is expected to decompress to exactly gkSegmentSize bytes; if the data turns out to be
+        // segmented differently, fall back to decompressing it in order.
+        struct SSegment
+        {
+            uint8 *pSrc;
+            uint32 SrcSize;
+            uint32 DstOffset;
+            uint32 DstSize;
+            bool Compressed;
+        };
+        std::vector<SSegment> Segments;
+        Segments.reserve((DstLen + gkSegmentSize - 1) / gkSegmentSize);
 
-        int32 Error = deflateInit(&z, 9);
+        uint8 *pSrcEnd = pSrc + SrcLen;
+        uint32 DstOffset = 0;
+        bool CanRunParallel = true;
 
-        if (!Error)
+        for (uint8 *pCur = pSrc; pCur < pSrcEnd; )
         {
-            Error = deflate(&z, Z_FINISH);
+            if (pCur + 2 > pSrcEnd || DstOffset >= DstLen)
+            {
+                CanRunParallel = false;
+                break;
+            }
 
-            if (!Error || Error == Z_STREAM_END)
-                Error = deflateEnd(&z);
+            int16 Size = (pCur[0] << 8) | pCur[1];
+            pCur += 2;
 
-            rTotalOut = z.total_out;
+            SSegment Segment;
+            Segment.Compressed = (Size >= 0);
+            Segment.SrcSize = (Size < 0 ? -Size : Size);
+            Segment.pSrc = pCur;
+            Segment.DstOffset = DstOffset;
+            Segment.DstSize = std::min<uint32>(gkSegmentSize, DstLen - DstOffset);
+
+            if ( (pCur + Segment.SrcSize > pSrcEnd) ||
+                 (!Segment.Compressed && Segment.SrcSize != Segment.DstSize) )
+            {
+                CanRunParallel = false;
+                break;
+            }
+
+            Segments.push_back(Segment);
+            pCur += Segment.SrcSize;
+            DstOffset += Segment.DstSize;
         }
 
-        if (Error && Error != Z_STREAM_END)
+        if (!CanRunParallel || DstOffset != DstLen || Segments.size() <= 1)
+            return DecompressSegmentedDataSequential(pSrc, SrcLen, pDst, DstLen);
+
+        std::vector<uint8> SegmentResults(Segments.size(), 0);
+
+        CWorkerPool::Shared()->ParallelFor(Segments.size(), [&](uint32 SegmentIdx)
         {
-            errorf("zlib error: %s", ErrorText_zlib(Error));
-            return false;
+            const SSegment& rkSegment = Segments[SegmentIdx];
+            uint8 *pSegmentDst = pDst + rkSegment.DstOffset;
+
+            if (!rkSegment.Compressed)
+            {
+                memcpy(pSegmentDst, rkSegment.pSrc, rkSegment.SrcSize);
+                SegmentResults[SegmentIdx] = 1;
+            }
+            else
+            {
+                // Failures here just mean the layout guess was wrong, so don't log them. The
+                // sequential fallback reports any errors that are actually in the data.
+                uint32 TotalOut = 0;
+                bool Success = DecompressSegment(rkSegment.pSrc, rkSegment.SrcSize, pSegmentDst, rkSegment.DstSize, TotalOut, false);
+                SegmentResults[SegmentIdx] = (Success && TotalOut == rkSegment.DstSize) ? 1 : 0;
+            }
+        });
+
+        for (uint32 SegmentIdx = 0; SegmentIdx < Segments.size(); SegmentIdx++)
+        {
+            if (!SegmentResults[SegmentIdx])
+                return DecompressSegmentedDataSequential(pSrc, SrcLen, pDst, DstLen);
         }
 
-        else return true;
+        return true;
     }
 
-    bool CompressLZO(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut)
+    // ************ COMPRESS ************
+    bool CompressZlib(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut, ECookProfile Profile /*= ECookProfile::Max*/)
     {
-#if USE_LZOKAY
-        rTotalOut = DstLen;
-        lzokay::EResult Result = lzokay::compress(pSrc, (size_t) SrcLen, pDst, (size_t&) rTotalOut);
+        return CCompressionContext::ThreadContext().CompressZlib(pSrc, SrcLen, pDst, DstLen, rTotalOut, Profile);
+    }
 
-        if (Result < lzokay::EResult::Success)
-        {
-            errorf("LZO error: %s", ErrorText_LZO(Result));
-            return false;
-        }
+    bool CompressLZO(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut, ECookProfile Profile /*= ECookProfile::Max*/)
+    {
+        return CCompressionContext::ThreadContext().CompressLZO(pSrc, SrcLen, pDst, DstLen, rTotalOut, Profile);
+    }
 
-        return true;
-#else
-        lzo_init();
+    uint32 CompressSegmentBound(uint32 SrcLen, bool IsZlib)
+    {
+        if (IsZlib)
+            return (uint32) compressBound(SrcLen);
+        else
+            // Worst case expansion for LZO1X as documented by the LZO library
+            return SrcLen + (SrcLen / 16) + 64 + 3;
+    }
 
-        uint8 *pWorkMem = new uint8[LZO1X_999_MEM_COMPRESS];
-        int32 Error = lzo1x_999_compress(pSrc, SrcLen, pDst, (lzo_uint*) &rTotalOut, pWorkMem);
-        delete[] pWorkMem;
+    uint32 CompressSegmentedBound(uint32 SrcLen, bool IsZlib, bool AllowUncompressedSegments)
+    {
+        uint32 NumFullSegments = SrcLen / gkSegmentSize;
+        uint32 Remainder = SrcLen % gkSegmentSize;
 
-        if (Error)
-        {
-            errorf("LZO error: %s", ErrorText_LZO(Error));
-            return false;
-        }
+        // Each segment gets a two-byte size header. With uncompressed segments allowed, a segment
+        // never takes up more space than its source data.
+        uint32 FullSegmentSize = (AllowUncompressedSegments ? gkSegmentSize : CompressSegmentBound(gkSegmentSize, IsZlib));
+        uint32 Bound = NumFullSegments * (2 + FullSegmentSize);
 
-        return true;
-#endif
+        if (Remainder > 0)
+            Bound += 2 + (AllowUncompressedSegments ? Remainder : CompressSegmentBound(Remainder, IsZlib));
+
+        return Bound;
     }
 
-    bool CompressSegmentedData(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32& rTotalOut, bool IsZlib, bool AllowUncompressedSegments)
+    /** Compress up to gkSegmentsPerBatch segments in parallel and pass each finished segment
+     *  (including its size header) to kWriteFunc in order.
+     */
+    bool CompressSegmentsParallel(uint8 *pSrc, uint32 SrcLen, bool IsZlib, bool AllowUncompressedSegments, ECookProfile Profile,
+                                  const std::function<void(const uint8*, uint32)>& kWriteFunc)
     {
-        uint8 *pSrcEnd = pSrc + SrcLen;
-        uint8 *pDstStart = pDst;
+        uint32 NumSegments = (SrcLen + gkSegmentSize - 1) / gkSegmentSize;
+        uint32 SlotSize = 2 + CompressSegmentBound(gkSegmentSize, IsZlib);
+        uint32 BatchSize = std::min<uint32>(NumSegments, gkSegmentsPerBatch);
+
+        std::vector<uint8> Scratch(BatchSize * SlotSize);
+        std::vector<uint32> SegmentSizes(BatchSize);
+        std::vector<uint8> SegmentResults(BatchSize);
 
-        while (pSrc < pSrcEnd)
+        for (uint32 BatchStart = 0; BatchStart < NumSegments; BatchStart += BatchSize)
         {
-            // Each segment is compressed separately. Segment size should always be 0x4000 unless there's less than 0x4000 bytes left.
-            uint16 Size;
-            uint32 Remaining = (uint32) (pSrcEnd - pSrc);
+            uint32 NumInBatch = std::min<uint32>(BatchSize, NumSegments - BatchStart);
 
-            if (Remaining < 0x4000) Size = (uint16) Remaining;
-            else Size = 0x4000;
+            CWorkerPool::Shared()->ParallelFor(NumInBatch, [&](uint32 SlotIdx)
+            {
+                uint32 SrcOffset = (BatchStart + SlotIdx) * gkSegmentSize;
+                uint16 Size = (uint16) std::min<uint32>(gkSegmentSize, SrcLen - SrcOffset);
+                uint8 *pSegmentSrc = pSrc + SrcOffset;
+                uint8 *pSlot = &Scratch[SlotIdx * SlotSize];
+                uint32 TotalOut = 0;
+                bool Success;
+
+                if (IsZlib)
+                    Success = CompressZlib(pSegmentSrc, Size, pSlot + 2, SlotSize - 2, TotalOut, Profile);
+                else
+                    Success = CompressLZO(pSegmentSrc, Size, pSlot + 2, SlotSize - 2, TotalOut, Profile);
 
-            std::vector<uint8> Compressed(Size * 2);
-            uint32 TotalOut;
+                SegmentResults[SlotIdx] = (Success ? 1 : 0);
 
-            if (IsZlib)
-                CompressZlib(pSrc, Size, Compressed.data(), Compressed.size(), TotalOut);
-            else
-                CompressLZO(pSrc, Size, Compressed.data(), Compressed.size(), TotalOut);
+                // Store the segment uncompressed if compressing it didn't make it any smaller
+                if (AllowUncompressedSegments && (!Success || TotalOut >= Size))
+                {
+                    // Negative size value signifies uncompressed data
+                    pSlot[0] = -Size >> 8;
+                    pSlot[1] = -Size & 0xFF;
+                    memcpy(pSlot + 2, pSegmentSrc, Size);
+                    TotalOut = Size;
+                    SegmentResults[SlotIdx] = 1;
+                }
+                else
+                {
+                    pSlot[0] = (TotalOut >> 8) & 0xFF;
+                    pSlot[1] = (TotalOut & 0xFF);
+                }
 
-            // Verify that the compressed data is actually smaller.
-            if (AllowUncompressedSegments && TotalOut >= Size)
+                SegmentSizes[SlotIdx] = 2 + TotalOut;
+            });
+
+            for (uint32 SlotIdx = 0; SlotIdx < NumInBatch; SlotIdx++)
             {
-                // Write negative size value to destination (which signifies uncompressed)
-                *pDst++ = -Size >> 8;
-                *pDst++ = -Size & 0xFF;
+                if (!SegmentResults[SlotIdx])
+                    return false;
 
-                // Write original uncompressed data to destination
-                memcpy(pDst, pSrc, Size);
-                TotalOut = Size;
+                kWriteFunc(&Scratch[SlotIdx * SlotSize], SegmentSizes[SlotIdx]);
             }
+        }
 
-            // If it IS smaller, write the compressed data
-            else
-            {
-                // Write new compressed size + data to destination
-                *pDst++ = (TotalOut >> 8) & 0xFF;
-                *pDst++ = (TotalOut & 0xFF);
-                memcpy(pDst, Compressed.data(), TotalOut);
-            }
+        return true;
+    }
 
-            pSrc += Size;
-            pDst += TotalOut;
-        }
+    bool CompressSegmentedData(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32& rTotalOut, bool IsZlib, bool AllowUncompressedSegments, ECookProfile Profile /*= ECookProfile::Max*/)
+    {
+        uint8 *pDstStart = pDst;
+
+        bool Success = CompressSegmentsParallel(pSrc, SrcLen, IsZlib, AllowUncompressedSegments, Profile, [&pDst](const uint8 *pkData, uint32 Size)
+        {
+            memcpy(pDst, pkData, Size);
+            pDst += Size;
+        });
 
         rTotalOut = (uint32) (pDst - pDstStart);
-        return true;
+        return Success;
     }
 
-    bool CompressZlibSegmented(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32& rTotalOut, bool AllowUncompressedSegments)
+    bool CompressZlibSegmented(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32& rTotalOut, bool AllowUncompressedSegments, ECookProfile Profile /*= ECookProfile::Max*/)
     {
-        return CompressSegmentedData(pSrc, SrcLen, pDst, rTotalOut, true, AllowUncompressedSegments);
+        return CompressSegmentedData(pSrc, SrcLen, pDst, rTotalOut, true, AllowUncompressedSegments, Profile);
     }
 
-    bool CompressLZOSegmented(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32& rTotalOut, bool AllowUncompressedSegments)
+    bool CompressLZOSegmented(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32& rTotalOut, bool AllowUncompressedSegments, ECookProfile Profile /*= ECookProfile::Max*/)
     {
-        return CompressSegmentedData(pSrc, SrcLen, pDst, rTotalOut, false, AllowUncompressedSegments);
+        return CompressSegmentedData(pSrc, SrcLen, pDst, rTotalOut, false, AllowUncompressedSegments, Profile);
     }
 }
@@ -5,19 +5,65 @@
 #include <Common/FileIO.h>
 #include <Common/TString.h>
 
+/** Size vs. speed tuning for cooking */
+enum class ECookProfile
+{
+    Fast,       // Fastest cook; assets are stored uncompressed wherever the game allows it
+    Balanced,   // zlib level 6, LZO1X-1
+    Max         // Smallest output; zlib level 9, LZO1X-999
+};
+
 namespace CompressionUtil
 {
+    /** Codec state that is kept alive between calls. zlib streams are reset instead of being
+     *  reinitialized, and LZO work memory is allocated once. Contexts aren't thread-safe;
+     *  the free functions below use one context per thread via ThreadContext().
+     */
+    class CCompressionContext
+    {
+        struct SCodecState;
+        SCodecState *mpState;
+
+    public:
+        CCompressionContext();
+        ~CCompressionContext();
+        CCompressionContext(const CCompressionContext&) = delete;
+        CCompressionContext& operator=(const CCompressionContext&) = delete;
+
+        bool DecompressZlib(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut, bool LogErrors = true);
+        bool DecompressLZO(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut, bool LogErrors = true);
+        bool CompressZlib(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut, ECookProfile Profile = ECookProfile::Max);
+        bool CompressLZO(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut, ECookProfile Profile = ECookProfile::Max);
+
+        /** Context owned by the calling thread */
+        static CCompressionContext& ThreadContext();
+    };
+
     // Decompression
     bool DecompressZlib(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut);
-    bool DecompressLZO(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32& rTotalOut);
+    bool DecompressLZO(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut);
+    bool DecompressSegment(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut, bool LogErrors = true);
+    bool DecompressSegmentedDataSequential(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen);
+
+    /** Decompress Retro's segmented format. Segments are decompressed in parallel on the shared worker pool. */
     bool DecompressSegmentedData(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen);
 
     // Compression
-    bool CompressZlib(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut);
-    bool CompressLZO(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32& rTotalOut);
-    bool CompressSegmentedData(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32& rTotalOut, bool IsZlib, bool AllowUncompressedSegments);
-    bool CompressZlibSegmented(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32& rTotalOut, bool AllowUncompressedSegments);
-    bool CompressLZOSegmented(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32& rTotalOut, bool AllowUncompressedSegments);
+    bool CompressZlib(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut, ECookProfile Profile = ECookProfile::Max);
+    bool CompressLZO(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32 DstLen, uint32& rTotalOut, ECookProfile Profile = ECookProfile::Max);
+
+    /** Worst-case output size for compressing SrcLen bytes as a single zlib/LZO block */
+    uint32 CompressSegmentBound(uint32 SrcLen, bool IsZlib);
+
+    /** Worst-case output size for CompressSegmentedData, including segment headers */
+    uint32 CompressSegmentedBound(uint32 SrcLen, bool IsZlib, bool AllowUncompressedSegments);
+
+    /** Compress to Retro's segmented format. Segments are compressed in parallel on the shared worker pool.
+     *  pDst must hold at least CompressSegmentedBound(SrcLen) bytes.
+     */
+    bool CompressSegmentedData(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32& rTotalOut, bool IsZlib, bool AllowUncompressedSegments, ECookProfile Profile = ECookProfile::Max);
+    bool CompressZlibSegmented(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32& rTotalOut, bool AllowUncompressedSegments, ECookProfile Profile = ECookProfile::Max);
+    bool CompressLZOSegmented(uint8 *pSrc, uint32 SrcLen, uint8 *pDst, uint32& rTotalOut, bool AllowUncompressedSegments, ECookProfile Profile = ECookProfile::Max);
 }
 
 #endif // COMPRESSIONUTIL_H
@@ -108,6 +108,7 @@ HEADERS += \
     Resource/Script/CScriptLayer.h \
     Resource/Script/CScriptObject.h \
     Resource/Script/CScriptTemplate.h \
+    Resource/Script/CPropertyPlan.h \
     Resource/Script/EVolumeShape.h \
     Resource/CCollisionMesh.h \
     Resource/CCollisionMeshGroup.h \
@@ -149,6 +150,8 @@ HEADERS += \
     OpenGL/CRenderbuffer.h \
     OpenGL/CShader.h \
     OpenGL/CShaderGenerator.h \
+    OpenGL/NShaderCache.h \
+    OpenGL/NShaderPregen.h \
     OpenGL/CUniformBuffer.h \
     OpenGL/CVertexArrayManager.h \
     OpenGL/CVertexBuffer.h \
@@ -173,11 +176,13 @@ HEADERS += \
     Render/CBoneTransformData.h \
     Resource/Factory/CSkinLoader.h \
     Render/EDepthGroup.h \
+    Render/CPosedMesh.h \
     Scene/CScriptAttachNode.h \
     ScriptExtra/CSandwormExtra.h \
     Resource/CCollisionMaterial.h \
     GameProject/CGameProject.h \
     GameProject/CPackage.h \
+    GameProject/CCookedBlobCache.h \
     GameProject/CGameExporter.h \
     GameProject/CResourceStore.h \
     GameProject/CVirtualDirectory.h \
@@ -196,6 +201,7 @@ HEADERS += \
     Resource/CAudioLookupTable.h \
     Resource/CStringList.h \
     CAudioManager.h \
+    CWorkerPool.h \
     Resource/Factory/CAnimEventLoader.h \
     Resource/AnimationClasses.h \
     Resource/Animation/CAnimation.h \
@@ -246,7 +252,8 @@ HEADERS += \
     Resource/Script/Property/CGuidProperty.h \
     Resource/Script/CGameTemplate.h \
     Resource/Script/NPropertyMap.h \
-    Resource/Script/NGameList.h
+    Resource/Script/NGameList.h \
+    Resource/Script/NTemplateCache.h
 
 # Source Files
 SOURCES += \
@@ -255,6 +262,7 @@ SOURCES += \
     Render/CGraphics.cpp \
     Render/CRenderer.cpp \
     Render/CRenderBucket.cpp \
+    Render/CPosedMesh.cpp \
     Resource/Area/CGameArea.cpp \
     Resource/Cooker/CMaterialCooker.cpp \
     Resource/Cooker/CModelCooker.cpp \
@@ -277,6 +285,7 @@ SOURCES += \
     Resource/Model/SSurface.cpp \
     Resource/Script/CScriptObject.cpp \
     Resource/Script/CScriptTemplate.cpp \
+    Resource/Script/CPropertyPlan.cpp \
     Resource/CCollisionMesh.cpp \
     Resource/CFont.cpp \
     Resource/CLight.cpp \
@@ -303,6 +312,8 @@ SOURCES += \
     OpenGL/CIndexBuffer.cpp \
     OpenGL/CShader.cpp \
     OpenGL/CShaderGenerator.cpp \
+    OpenGL/NShaderCache.cpp \
+    OpenGL/NShaderPregen.cpp \
     OpenGL/CVertexArrayManager.cpp \
     OpenGL/CVertexBuffer.cpp \
     OpenGL/GLCommon.cpp \
@@ -330,6 +341,7 @@ SOURCES += \
     GameProject/CVirtualDirectory.cpp \
     GameProject/CResourceEntry.cpp \
     GameProject/CPackage.cpp \
+    GameProject/CCookedBlobCache.cpp \
     Resource/Factory/CDependencyGroupLoader.cpp \
     GameProject/CDependencyTree.cpp \
     Resource/Factory/CUnsupportedFormatLoader.cpp \
@@ -337,6 +349,7 @@ SOURCES += \
     GameProject/DependencyListBuilders.cpp \
     Resource/Factory/CAudioGroupLoader.cpp \
     CAudioManager.cpp \
+    CWorkerPool.cpp \
     Resource/Factory/CAnimEventLoader.cpp \
     Resource/Animation/CAnimation.cpp \
     Resource/Animation/CAnimationParameters.cpp \
@@ -357,7 +370,8 @@ SOURCES += \
     Resource/Script/Property/CFlagsProperty.cpp \
     Resource/Script/CGameTemplate.cpp \
     Resource/Script/NPropertyMap.cpp \
-    Resource/Script/NGameList.cpp
+    Resource/Script/NGameList.cpp \
+    Resource/Script/NTemplateCache.cpp
 
 # Codegen
 CODEGEN_DIR = $$EXTERNALS_DIR/CodeGen
@@ -7,7 +7,10 @@
 #include "Core/Resource/CWorld.h"
 #include "Core/Resource/Animation/CAnimSet.h"
 #include "Core/Resource/Script/CScriptLayer.h"
+#include "Core/CWorkerPool.h"
 #include <Common/Math/MathUtil.h>
+#include <functional>
+#include <set>
 
 #define REVERT_AUTO_NAMES 1
 #define PROCESS_PACKAGES 1
@@ -83,6 +86,131 @@ void ApplyGeneratedName(CResourceEntry *pEntry, const TString& rkDir, const TStr
     ASSERT(Success);
 }
 
+/** Number of resources whose cooked data is read ahead at a time */
+const uint32 gkPrefetchBatchSize = 64;
+
+/** Names picked for assets during one generation pass. Resources are loaded and names are proposed
+ *  first, then the proposals are applied in the order they were made. This gives the same result as
+ *  renaming each asset as soon as its name is known, as long as the proposing code checks
+ *  HasProposal() wherever it would otherwise check whether an asset has already been named.
+ */
+class CNameProposals
+{
+    struct SProposal
+    {
+        CResourceEntry *pEntry;
+        TString Dir;
+        TString Name;
+        bool Hide;
+    };
+    std::vector<SProposal> mProposals;
+    std::set<CResourceEntry*> mProposedEntries;
+
+public:
+    void Propose(CResourceEntry *pEntry, const TString& rkDir, const TString& rkName, bool Hide = false)
+    {
+        ASSERT(pEntry != nullptr);
+        mProposals.push_back( SProposal { pEntry, rkDir, rkName, Hide } );
+        mProposedEntries.insert(pEntry);
+    }
+
+    bool HasProposal(CResourceEntry *pEntry) const
+    {
+        return mProposedEntries.find(pEntry) != mProposedEntries.end();
+    }
+
+    void Apply()
+    {
+        for (uint32 PropIdx = 0; PropIdx < mProposals.size(); PropIdx++)
+        {
+            const SProposal& rkProp = mProposals[PropIdx];
+            ApplyGeneratedName(rkProp.pEntry, rkProp.Dir, rkProp.Name);
+            if (rkProp.Hide) rkProp.pEntry->SetHidden(true);
+        }
+
+        mProposals.clear();
+        mProposedEntries.clear();
+    }
+};
+
+/** Load every resource in the list and pass it to kFunc. Resource loaders aren't thread-safe, so
+ *  loading itself happens on this thread, but cooked data is read from disk on the worker pool one
+ *  batch ahead of the loaders. If DestroyUnreferenced is set, unreferenced resources are freed
+ *  after each batch to keep memory usage down.
+ */
+void ForEachLoadedResource(CResourceStore *pStore, const std::vector<CResourceEntry*>& rkEntries, bool DestroyUnreferenced,
+                           const std::function<void(CResourceEntry*, CResource*)>& kFunc)
+{
+    for (uint32 BatchStart = 0; BatchStart < rkEntries.size(); BatchStart += gkPrefetchBatchSize)
+    {
+        uint32 BatchSize = Math::Min<uint32>(gkPrefetchBatchSize, rkEntries.size() - BatchStart);
+
+        // Resolve paths up front; the workers only touch the filesystem
+        std::vector<TString> RawPaths(BatchSize);
+        std::vector<TString> CookedPaths(BatchSize);
+        std::vector< std::vector<uint8> > CookedData(BatchSize);
+
+        for (uint32 EntryIdx = 0; EntryIdx < BatchSize; EntryIdx++)
+        {
+            CResourceEntry *pEntry = rkEntries[BatchStart + EntryIdx];
+
+            if (!pEntry->IsLoaded())
+            {
+                RawPaths[EntryIdx] = pEntry->RawAssetPath();
+                CookedPaths[EntryIdx] = pEntry->CookedAssetPath();
+            }
+        }
+
+        CWorkerPool::Shared()->ParallelFor(BatchSize, [&](uint32 EntryIdx)
+        {
+            // Raw versions take priority over cooked data, so leave those for CResourceEntry::Load
+            if (CookedPaths[EntryIdx].IsEmpty() || FileUtil::Exists(RawPaths[EntryIdx]))
+                return;
+
+            CFileInStream File(CookedPaths[EntryIdx], EEndian::BigEndian);
+
+            if (File.IsValid())
+            {
+                CookedData[EntryIdx].resize(File.Size());
+                File.ReadBytes(CookedData[EntryIdx].data(), CookedData[EntryIdx].size());
+            }
+        });
+
+        for (uint32 EntryIdx = 0; EntryIdx < BatchSize; EntryIdx++)
+        {
+            CResourceEntry *pEntry = rkEntries[BatchStart + EntryIdx];
+            CResource *pRes;
+
+            if (!CookedData[EntryIdx].empty())
+            {
+                CMemoryInStream Mem(CookedData[EntryIdx].data(), CookedData[EntryIdx].size(), EEndian::BigEndian);
+                Mem.SetSourceString(CookedPaths[EntryIdx]);
+                pRes = pEntry->LoadCooked(Mem);
+            }
+            else
+                pRes = pEntry->Load();
+
+            kFunc(pEntry, pRes);
+        }
+
+        if (DestroyUnreferenced)
+            pStore->DestroyUnreferencedResources();
+    }
+}
+
+/** Collect all entries of the given type so they can be loaded in batches */
+template<EResourceType ResType>
+std::vector<CResourceEntry*> GetEntriesOfType(CResourceStore *pStore)
+{
+    std::vector<CResourceEntry*> Entries;
+    Entries.reserve(pStore->NumResourcesOfType(ResType));
+
+    for (TResourceIterator<ResType> It(pStore); It; ++It)
+        Entries.push_back(*It);
+
+    return Entries;
+}
+
 void GenerateAssetNames(CGameProject *pProj)
 {
     debugf("*** Generating Asset Names ***");
@@ -397,10 +525,11 @@ void GenerateAssetNames(CGameProject *pProj)
 #if PROCESS_MODELS
     // Generate Model Lightmap names
     debugf("Processing model lightmaps");
+    CNameProposals Proposals;
 
-    for (TResourceIterator<EResourceType::Model> It(pStore); It; ++It)
+    ForEachLoadedResource(pStore, GetEntriesOfType<EResourceType::Model>(pStore), true, [&](CResourceEntry *pEntry, CResource *pRes)
     {
-        CModel *pModel = (CModel*) It->Load();
+        CModel *pModel = (CModel*) pRes;
         uint32 LightmapNum = 0;
 
         for (uint32 iSet = 0; iSet < pModel->GetMatSetCount(); iSet++)
@@ -422,51 +551,53 @@ void GenerateAssetNames(CGameProject *pProj)
                     {
                         CTexture *pLightmapTex = pPass->Texture();
                         CResourceEntry *pTexEntry = pLightmapTex->Entry();
-                        if (pTexEntry->IsNamed() || pTexEntry->IsCategorized()) continue;
+                        if (pTexEntry->IsNamed() || pTexEntry->IsCategorized() || Proposals.HasProposal(pTexEntry)) continue;
 
-                        TString TexName = TString::Format("%s_lightmap%d", *It->Name(), LightmapNum);
-                        ApplyGeneratedName(pTexEntry, pModel->Entry()->DirectoryPath(), TexName);
-                        pTexEntry->SetHidden(true);
+                        TString TexName = TString::Format("%s_lightmap%d", *pEntry->Name(), LightmapNum);
+                        Proposals.Propose(pTexEntry, pEntry->DirectoryPath(), TexName, true);
                         LightmapNum++;
                     }
                 }
             }
         }
+    });
 
-        pStore->DestroyUnreferencedResources();
-    }
+    Proposals.Apply();
 #endif
 
 #if PROCESS_AUDIO_GROUPS
     // Generate Audio Group names
     debugf("Processing audio groups");
     const TString kAudioGrpDir = "Audio/";
+    CNameProposals GroupProposals;
 
-    for (TResourceIterator<EResourceType::AudioGroup> It(pStore); It; ++It)
+    ForEachLoadedResource(pStore, GetEntriesOfType<EResourceType::AudioGroup>(pStore), false, [&](CResourceEntry *pEntry, CResource *pRes)
     {
-        CAudioGroup *pGroup = (CAudioGroup*) It->Load();
-        TString GroupName = pGroup->GroupName();
-        ApplyGeneratedName(*It, kAudioGrpDir, GroupName);
-    }
+        CAudioGroup *pGroup = (CAudioGroup*) pRes;
+        GroupProposals.Propose(pEntry, kAudioGrpDir, pGroup->GroupName());
+    });
+
+    GroupProposals.Apply();
 #endif
 
 #if PROCESS_AUDIO_MACROS
     // Process audio macro/sample names
     debugf("Processing audio macros");
     const TString kSfxDir = "Audio/Uncategorized/";
+    CNameProposals MacroProposals;
 
-    for (TResourceIterator<EResourceType::AudioMacro> It(pStore); It; ++It)
+    ForEachLoadedResource(pStore, GetEntriesOfType<EResourceType::AudioMacro>(pStore), false, [&](CResourceEntry *pEntry, CResource *pRes)
     {
-        CAudioMacro *pMacro = (CAudioMacro*) It->Load();
+        CAudioMacro *pMacro = (CAudioMacro*) pRes;
         TString MacroName = pMacro->MacroName();
-        ApplyGeneratedName(*It, kSfxDir, MacroName);
+        MacroProposals.Propose(pEntry, kSfxDir, MacroName);
 
         for (uint32 iSamp = 0; iSamp < pMacro->NumSamples(); iSamp++)
         {
             CAssetID SampleID = pMacro->SampleByIndex(iSamp);
             CResourceEntry *pSample = pStore->FindEntry(SampleID);
 
-            if (pSample && !pSample->IsNamed())
+            if (pSample && !pSample->IsNamed() && !MacroProposals.HasProposal(pSample))
             {
                 TString SampleName;
 
@@ -475,26 +606,28 @@ void GenerateAssetNames(CGameProject *pProj)
                 else
                     SampleName = TString::Format("%s_%d", *MacroName, iSamp);
 
-                ApplyGeneratedName(pSample, kSfxDir, SampleName);
+                MacroProposals.Propose(pSample, kSfxDir, SampleName);
             }
         }
-    }
+    });
+
+    MacroProposals.Apply();
 #endif
 
 #if PROCESS_ANIM_CHAR_SETS
     // Generate animation format names
-    // Hacky syntax because animsets are under eAnimSet in MP1/2 and eCharacter in MP3/DKCR
+    // Animsets are under eAnimSet in MP1/2 and eCharacter in MP3/DKCR
     debugf("Processing animation data");
-    CResourceIterator *pIter = (pProj->Game() <= EGame::Echoes ?
-                                    (CResourceIterator*) new TResourceIterator<EResourceType::AnimSet> :
-                                    (CResourceIterator*) new TResourceIterator<EResourceType::Character>);
-    CResourceIterator& It = *pIter;
+    std::vector<CResourceEntry*> AnimSetEntries = (pProj->Game() <= EGame::Echoes ?
+                                                   GetEntriesOfType<EResourceType::AnimSet>(pStore) :
+                                                   GetEntriesOfType<EResourceType::Character>(pStore));
+    CNameProposals AnimProposals;
 
-    for (; It; ++It)
+    ForEachLoadedResource(pStore, AnimSetEntries, false, [&](CResourceEntry *pSetEntry, CResource *pRes)
     {
-        TString SetDir = It->DirectoryPath();
+        TString SetDir = pSetEntry->DirectoryPath();
         TString NewSetName;
-        CAnimSet *pSet = (CAnimSet*) It->Load();
+        CAnimSet *pSet = (CAnimSet*) pRes;
 
         for (uint32 iChar = 0; iChar < pSet->NumCharacters(); iChar++)
         {
@@ -503,9 +636,9 @@ void GenerateAssetNames(CGameProject *pProj)
             TString CharName = pkChar->Name;
             if (iChar == 0) NewSetName = CharName;
 
-            if (pkChar->pModel)     ApplyGeneratedName(pkChar->pModel->Entry(), SetDir, CharName);
-            if (pkChar->pSkeleton)  ApplyGeneratedName(pkChar->pSkeleton->Entry(), SetDir, CharName);
-            if (pkChar->pSkin)      ApplyGeneratedName(pkChar->pSkin->Entry(), SetDir, CharName);
+            if (pkChar->pModel)     AnimProposals.Propose(pkChar->pModel->Entry(), SetDir, CharName);
+            if (pkChar->pSkeleton)  AnimProposals.Propose(pkChar->pSkeleton->Entry(), SetDir, CharName);
+            if (pkChar->pSkin)      AnimProposals.Propose(pkChar->pSkin->Entry(), SetDir, CharName);
 
             if (pProj->Game() >= EGame::CorruptionProto && pProj->Game() <= EGame::Corruption && pkChar->ID == 0)
             {
@@ -514,7 +647,7 @@ void GenerateAssetNames(CGameProject *pProj)
                 if (pAnimDataEntry)
                 {
                     TString AnimDataName = TString::Format("%s_animdata", *CharName);
-                    ApplyGeneratedName(pAnimDataEntry, SetDir, AnimDataName);
+                    AnimProposals.Propose(pAnimDataEntry, SetDir, AnimDataName);
                 }
             }
 
@@ -538,19 +671,19 @@ void GenerateAssetNames(CGameProject *pProj)
                     if (rkOverlay.ModelID.IsValid())
                     {
                         CResourceEntry *pModelEntry = pStore->FindEntry(rkOverlay.ModelID);
-                        ApplyGeneratedName(pModelEntry, SetDir, OverlayName);
+                        AnimProposals.Propose(pModelEntry, SetDir, OverlayName);
                     }
                     if (rkOverlay.SkinID.IsValid())
                     {
                         CResourceEntry *pSkinEntry = pStore->FindEntry(rkOverlay.SkinID);
-                        ApplyGeneratedName(pSkinEntry, SetDir, OverlayName);
+                        AnimProposals.Propose(pSkinEntry, SetDir, OverlayName);
                     }
                 }
             }
         }
 
         if (!NewSetName.IsEmpty())
-            ApplyGeneratedName(*It, SetDir, NewSetName);
+            AnimProposals.Propose(pSetEntry, SetDir, NewSetName);
 
         std::set<CAnimPrimitive> AnimPrimitives;
         pSet->GetUniquePrimitives(AnimPrimitives);
@@ -562,26 +695,35 @@ void GenerateAssetNames(CGameProject *pProj)
 
             if (pAnim)
             {
-                ApplyGeneratedName(pAnim->Entry(), SetDir, rkPrim.Name());
+                AnimProposals.Propose(pAnim->Entry(), SetDir, rkPrim.Name());
                 CAnimEventData *pEvents = pAnim->EventData();
 
                 if (pEvents)
-                    ApplyGeneratedName(pEvents->Entry(), SetDir, rkPrim.Name());
+                    AnimProposals.Propose(pEvents->Entry(), SetDir, rkPrim.Name());
             }
         }
-    }
-    delete pIter;
+    });
+
+    AnimProposals.Apply();
 #endif
 
 #if PROCESS_STRINGS
     // Generate string names
     debugf("Processing strings");
     const TString kStringsDir = "Strings/Uncategorized/";
+    CNameProposals StringProposals;
+
+    std::vector<CResourceEntry*> StringEntries;
 
     for (TResourceIterator<EResourceType::StringTable> It(pStore); It; ++It)
     {
-        if (It->IsNamed()) continue;
-        CStringTable *pString = (CStringTable*) It->Load();
+        if (!It->IsNamed())
+            StringEntries.push_back(*It);
+    }
+
+    ForEachLoadedResource(pStore, StringEntries, false, [&](CResourceEntry *pEntry, CResource *pRes)
+    {
+        CStringTable *pString = (CStringTable*) pRes;
         TString String;
 
         for (uint32 iStr = 0; iStr < pString->NumStrings() && String.IsEmpty(); iStr++)
@@ -595,18 +737,29 @@ void GenerateAssetNames(CGameProject *pProj)
             while (Name.EndsWith(".") || TString::IsWhitespace(Name.Back()))
                 Name = Name.ChopBack(1);
 
-            ApplyGeneratedName(pString->Entry(), kStringsDir, Name);
+            StringProposals.Propose(pEntry, kStringsDir, Name);
         }
-    }
+    });
+
+    StringProposals.Apply();
 #endif
 
 #if PROCESS_SCANS
     // Generate scan names
     debugf("Processing scans");
+    CNameProposals ScanProposals;
+
+    std::vector<CResourceEntry*> ScanEntries;
+
     for (TResourceIterator<EResourceType::Scan> It(pStore); It; ++It)
     {
-        if (It->IsNamed()) continue;
-        CScan *pScan = (CScan*) It->Load();
+        if (!It->IsNamed())
+            ScanEntries.push_back(*It);
+    }
+
+    ForEachLoadedResource(pStore, ScanEntries, false, [&](CResourceEntry *pScanEntry, CResource *pRes)
+    {
+        CScan *pScan = (CScan*) pRes;
         TString ScanName;
 
         if (pProj->Game() >= EGame::EchoesDemo)
@@ -622,40 +775,53 @@ void GenerateAssetNames(CGameProject *pProj)
             if (pString) ScanName = pString->Entry()->Name();
         }
 
-        ApplyGeneratedName(pScan->Entry(), It->DirectoryPath(), ScanName);
+        ScanProposals.Propose(pScanEntry, pScanEntry->DirectoryPath(), ScanName);
 
         if (!ScanName.IsEmpty() && pProj->Game() <= EGame::Prime)
         {
             CAssetID FrameID = pScan->GuiFrame();
             CResourceEntry *pEntry = pStore->FindEntry(FrameID);
-            if (pEntry) ApplyGeneratedName(pEntry, pEntry->DirectoryPath(), "ScanFrame");
+            if (pEntry) ScanProposals.Propose(pEntry, pEntry->DirectoryPath(), "ScanFrame");
 
             for (uint32 iImg = 0; iImg < 4; iImg++)
             {
                 CAssetID ImageID = pScan->ScanImage(iImg);
                 CResourceEntry *pImgEntry = pStore->FindEntry(ImageID);
-                if (pImgEntry) ApplyGeneratedName(pImgEntry, pImgEntry->DirectoryPath(), TString::Format("%s_Image%d", *ScanName, iImg));
+                if (pImgEntry) ScanProposals.Propose(pImgEntry, pImgEntry->DirectoryPath(), TString::Format("%s_Image%d", *ScanName, iImg));
             }
         }
-    }
+    });
+
+    ScanProposals.Apply();
 #endif
 
 #if PROCESS_FONTS
     // Generate font names
     debugf("Processing fonts");
-    for (TResourceIterator<EResourceType::Font> It(pStore); It; ++It)
+    CNameProposals FontProposals;
+    std::vector< TResPtr<CFont> > Fonts;
+
+    ForEachLoadedResource(pStore, GetEntriesOfType<EResourceType::Font>(pStore), false, [&](CResourceEntry *pEntry, CResource *pRes)
     {
-        CFont *pFont = (CFont*) It->Load();
+        CFont *pFont = (CFont*) pRes;
 
         if (pFont)
         {
-            ApplyGeneratedName(pFont->Entry(), pFont->Entry()->DirectoryPath(), pFont->FontName());
+            FontProposals.Propose(pEntry, pEntry->DirectoryPath(), pFont->FontName());
+            Fonts.push_back(pFont);
+        }
+    });
 
-            CTexture *pFontTex = pFont->Texture();
+    FontProposals.Apply();
 
-            if (pFontTex)
-                ApplyGeneratedName(pFontTex->Entry(), pFont->Entry()->DirectoryPath(), pFont->Entry()->Name() + "_tex");
-        }
+    // Font textures are named after the font's final name, so they need a second pass
+    for (uint32 FontIdx = 0; FontIdx < Fonts.size(); FontIdx++)
+    {
+        CFont *pFont = Fonts[FontIdx];
+        CTexture *pFontTex = pFont->Texture();
+
+        if (pFontTex)
+            ApplyGeneratedName(pFontTex->Entry(), pFont->Entry()->DirectoryPath(), pFont->Entry()->Name() + "_tex");
     }
 #endif
 
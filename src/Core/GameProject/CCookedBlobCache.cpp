@@ -0,0 +1,71 @@
+#include "CCookedBlobCache.h"
+
+/** Total size of compressed data the cache will hold; once this is reached, new blobs are no longer stored */
+const uint64 gkMaxBlobCacheSize = 512ull * 1024 * 1024;
+
+bool CCookedBlobCache::SBlobKey::operator<(const SBlobKey& rkOther) const
+{
+    if (SourceHash != rkOther.SourceHash)   return SourceHash < rkOther.SourceHash;
+    if (SourceSize != rkOther.SourceSize)   return SourceSize < rkOther.SourceSize;
+    if (IsZlib != rkOther.IsZlib)           return IsZlib < rkOther.IsZlib;
+    return Profile < rkOther.Profile;
+}
+
+CCookedBlobCache::CCookedBlobCache()
+    : mTotalBlobSize(0)
+    , mNumHits(0)
+    , mBytesNotRead(0)
+    , mTimeSaved(0.0)
+{
+}
+
+const CCookedBlobCache::SBlob* CCookedBlobCache::FindBlob(const SBlobKey& rkKey) const
+{
+    auto Find = mBlobs.find(rkKey);
+    return (Find == mBlobs.end() ? nullptr : &Find->second);
+}
+
+const CCookedBlobCache::SBlob* CCookedBlobCache::FindAssetBlob(const CAssetID& rkID, SBlobKey& rOutKey) const
+{
+    // Only valid if the cooked file hasn't been rewritten since we last read it
+    auto Find = mAssetKeys.find(rkID);
+    if (Find == mAssetKeys.end()) return nullptr;
+
+    rOutKey = Find->second;
+    return FindBlob(rOutKey);
+}
+
+const CCookedBlobCache::SBlob* CCookedBlobCache::AddBlob(const CAssetID& rkID, const SBlobKey& rkKey, bool Compressed, const uint8 *pkData, uint32 DataSize, double CompressTime)
+{
+    SetAssetKey(rkID, rkKey);
+
+    const SBlob *pkExisting = FindBlob(rkKey);
+    if (pkExisting) return pkExisting;
+
+    if (!Compressed) DataSize = 0;
+    if (mTotalBlobSize + DataSize > gkMaxBlobCacheSize) return nullptr;
+
+    SBlob& rBlob = mBlobs[rkKey];
+    rBlob.Compressed = Compressed;
+    rBlob.Data.assign(pkData, pkData + DataSize);
+    rBlob.CompressTime = CompressTime;
+    mTotalBlobSize += DataSize;
+    return &rBlob;
+}
+
+void CCookedBlobCache::SetAssetKey(const CAssetID& rkID, const SBlobKey& rkKey)
+{
+    mAssetKeys[rkID] = rkKey;
+}
+
+void CCookedBlobCache::InvalidateAsset(const CAssetID& rkID)
+{
+    mAssetKeys.erase(rkID);
+}
+
+void CCookedBlobCache::RecordHit(const SBlobKey& rkKey, const SBlob& rkBlob, bool SkippedRead)
+{
+    mNumHits++;
+    mTimeSaved += rkBlob.CompressTime;
+    if (SkippedRead) mBytesNotRead += rkKey.SourceSize;
+}
@@ -0,0 +1,61 @@
+#ifndef CCOOKEDBLOBCACHE_H
+#define CCOOKEDBLOBCACHE_H
+
+#include "Core/CompressionUtil.h"
+#include <Common/BasicTypes.h>
+#include <Common/CAssetID.h>
+#include <map>
+#include <vector>
+
+/** Compressed asset data shared between all the package cooks in a single run.
+ *  Blobs are keyed by the hash and size of the cooked file plus the compression settings,
+ *  so an asset that appears in several paks is only read and compressed once.
+ */
+class CCookedBlobCache
+{
+public:
+    struct SBlobKey
+    {
+        uint64 SourceHash;
+        uint32 SourceSize;
+        bool IsZlib;
+        ECookProfile Profile;
+
+        bool operator<(const SBlobKey& rkOther) const;
+    };
+
+    struct SBlob
+    {
+        bool Compressed;
+        std::vector<uint8> Data;
+        double CompressTime;
+    };
+
+private:
+    std::map<SBlobKey, SBlob> mBlobs;
+    std::map<CAssetID, SBlobKey> mAssetKeys;
+    uint64 mTotalBlobSize;
+
+    // Stats
+    uint32 mNumHits;
+    uint64 mBytesNotRead;
+    double mTimeSaved;
+
+public:
+    CCookedBlobCache();
+
+    const SBlob* FindBlob(const SBlobKey& rkKey) const;
+    const SBlob* FindAssetBlob(const CAssetID& rkID, SBlobKey& rOutKey) const;
+    const SBlob* AddBlob(const CAssetID& rkID, const SBlobKey& rkKey, bool Compressed, const uint8 *pkData, uint32 DataSize, double CompressTime);
+    void SetAssetKey(const CAssetID& rkID, const SBlobKey& rkKey);
+    void InvalidateAsset(const CAssetID& rkID);
+    void RecordHit(const SBlobKey& rkKey, const SBlob& rkBlob, bool SkippedRead);
+
+    // Accessors
+    inline uint32 NumBlobs() const          { return mBlobs.size(); }
+    inline uint32 NumHits() const           { return mNumHits; }
+    inline uint64 BytesNotRead() const      { return mBytesNotRead; }
+    inline double TimeSaved() const         { return mTimeSaved; }
+};
+
+#endif // CCOOKEDBLOBCACHE_H
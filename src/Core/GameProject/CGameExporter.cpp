@@ -19,7 +19,7 @@
 #define USE_ASSET_NAME_MAP 1
 #define EXPORT_COOKED 1
 
-CGameExporter::CGameExporter(EDiscType DiscType, EGame Game, bool FrontEnd, ERegion Region, const TString& rkGameName, const TString& rkGameID, float BuildVersion)
+CGameExporter::CGameExporter(EDiscType DiscType, EGame Game, bool FrontEnd, ERegion Region, const TString& rkGameName, const TString& rkGameID, float BuildVersion, const TString& rkSourceDiscPath /*= ""*/)
     : mGame(Game)
     , mRegion(Region)
     , mGameName(rkGameName)
@@ -27,6 +27,8 @@ CGameExporter::CGameExporter(EDiscType DiscType, EGame Game, bool FrontEnd, EReg
     , mBuildVersion(BuildVersion)
     , mDiscType(DiscType)
     , mFrontEnd(FrontEnd)
+    , mSourceDiscPath(rkSourceDiscPath)
+    , mStreamFromSourceDisc(false)
     , mpProgress(nullptr)
 {
     ASSERT(mGame != EGame::Invalid);
@@ -68,6 +70,8 @@ bool CGameExporter::Export(nod::DiscBase *pDisc, const TString& rkOutputDir, CAs
                 mBuildVersion);
 
     mpProject->SetProjectName(mGameName);
+    mpProject->SetSourceDiscPath(mSourceDiscPath);
+    mpProject->SetStreamFromSourceDisc(mStreamFromSourceDisc);
     mpStore = mpProject->ResourceStore();
     mResourcesDir = mpStore->ResourcesDir();
 
@@ -162,6 +166,21 @@ bool CGameExporter::ShouldExportDiscNode(const nod::Node *pkNode, bool IsInRoot)
     return true;
 }
 
+bool CGameExporter::ShouldExtractDiscFile(const nod::Node *pkNode) const
+{
+    // Unless streaming from the source disc was requested, the project gets a full copy of the filesystem
+    if (!mStreamFromSourceDisc)
+        return true;
+
+    // Otherwise, only extract files that the editor reads or rewrites. Everything else
+    // is streamed straight from the original disc image when the project is built.
+    TString Name = pkNode->getName().data();
+
+    return ( Name.GetFileExtension().CaseInsensitiveCompare("pak") ||
+             Name.CaseInsensitiveCompare("opening.bnr") ||
+             Name.CaseInsensitiveCompare("areas.lst") );
+}
+
 // ************ PROTECTED ************
 bool CGameExporter::ExtractDiscData()
 {
@@ -193,6 +212,10 @@ bool CGameExporter::ExtractDiscData()
 
     if (!mpProgress->ShouldCancel())
     {
+        // System files are taken from the source disc when the project is built
+        if (mStreamFromSourceDisc)
+            return true;
+
         Context.progressCB = nullptr;
 
         if (IsWii)
@@ -225,6 +248,9 @@ bool CGameExporter::ExtractDiscNodeRecursive(const nod::Node *pkNode, const TStr
 
         if (Iter->getKind() == nod::Node::Kind::File)
         {
+            if (!ShouldExtractDiscFile(&*Iter))
+                continue;
+
             TString FilePath = rkDir + Iter->getName().data();
             bool Success = Iter->extractToDirectory(*rkDir.ToUTF16(), rkContext);
             if (!Success) return false;
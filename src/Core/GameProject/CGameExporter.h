@@ -39,6 +39,8 @@ class CGameExporter
 
     // Files
     nod::DiscBase *mpDisc;
+    TString mSourceDiscPath;
+    bool mStreamFromSourceDisc;
     EDiscType mDiscType;
     bool mFrontEnd;
 
@@ -73,12 +75,14 @@ class CGameExporter
     };
 
 public:
-    CGameExporter(EDiscType DiscType, EGame Game, bool FrontEnd, ERegion Region, const TString& rkGameName, const TString& rkGameID, float BuildVersion);
+    CGameExporter(EDiscType DiscType, EGame Game, bool FrontEnd, ERegion Region, const TString& rkGameName, const TString& rkGameID, float BuildVersion, const TString& rkSourceDiscPath = "");
     bool Export(nod::DiscBase *pDisc, const TString& rkOutputDir, CAssetNameMap *pNameMap, CGameInfo *pGameInfo, IProgressNotifier *pProgress);
     void LoadResource(const CAssetID& rkID, std::vector<uint8>& rBuffer);
     bool ShouldExportDiscNode(const nod::Node *pkNode, bool IsInRoot);
+    bool ShouldExtractDiscFile(const nod::Node *pkNode) const;
 
-    inline TString ProjectPath() const  { return mProjectPath; }
+    inline TString ProjectPath() const              { return mProjectPath; }
+    inline void SetStreamFromSourceDisc(bool Stream) { mStreamFromSourceDisc = Stream; }
 
 protected:
     bool ExtractDiscData();
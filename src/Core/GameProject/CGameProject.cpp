@@ -1,4 +1,5 @@
 #include "CGameProject.h"
+#include "DependencyListBuilders.h"
 #include "IUIRelay.h"
 #include "Core/Resource/Script/CGameTemplate.h"
 #include <Common/Serialization/XML.h>
@@ -17,6 +18,9 @@ CGameProject::~CGameProject()
     for (uint32 iPkg = 0; iPkg < mPackages.size(); iPkg++)
         delete mPackages[iPkg];
 
+    // Cached area dependency lists refer to this project's resource store
+    CAreaDependencyListBuilder::ClearCache();
+
     delete mpAudioManager;
     delete mpGameInfo;
     delete mpResourceStore;
@@ -38,7 +42,10 @@ bool CGameProject::Serialize(IArchive& rArc)
     rArc << SerialParameter("Name", mProjectName)
          << SerialParameter("Region", mRegion)
          << SerialParameter("GameID", mGameID)
-         << SerialParameter("BuildVersion", mBuildVersion);
+         << SerialParameter("BuildVersion", mBuildVersion)
+         << SerialParameter("SourceDisc", mSourceDiscPath, SH_Optional)
+         << SerialParameter("StreamFromSourceDisc", mStreamFromSourceDisc, SH_Optional, false)
+         << SerialParameter("CookProfile", mCookProfile, SH_Optional, ECookProfile::Max);
 
     // Serialize package list
     std::vector<TString> PackageList;
@@ -79,7 +86,7 @@ bool CGameProject::Serialize(IArchive& rArc)
 bool CGameProject::BuildISO(const TString& rkIsoPath, IProgressNotifier *pProgress)
 {
     ASSERT( FileUtil::IsValidPath(rkIsoPath, false) );
-    ASSERT( !IsWiiDeAsobu() && !IsTrilogy() );
+    ASSERT( !NeedsDiscMerge() );
 
     auto ProgressCallback = [&](float ProgressPercent, const nod::SystemStringView& rkInfoString, size_t)
     {
@@ -101,10 +108,9 @@ bool CGameProject::BuildISO(const TString& rkIsoPath, IProgressNotifier *pProgre
     }
 }
 
-bool CGameProject::MergeISO(const TString& rkIsoPath, nod::DiscWii *pOriginalIso, IProgressNotifier *pProgress)
+bool CGameProject::MergeISO(const TString& rkIsoPath, nod::DiscBase *pOriginalIso, IProgressNotifier *pProgress)
 {
     ASSERT( FileUtil::IsValidPath(rkIsoPath, false) );
-    ASSERT( IsWiiDeAsobu() || IsTrilogy() );
     ASSERT( pOriginalIso != nullptr );
 
     auto ProgressCallback = [&](float ProgressPercent, const nod::SystemStringView& rkInfoString, size_t)
@@ -114,10 +120,20 @@ bool CGameProject::MergeISO(const TString& rkIsoPath, nod::DiscWii *pOriginalIso
 
     pProgress->SetTask(0, "Building " + rkIsoPath.GetFileName());
 
+    // Files present in the project's disc filesystem override the originals; everything else
+    // is copied straight out of the source image.
     TWideString DiscRoot = DiscFilesystemRoot(false).ToUTF16();
 
-    nod::DiscMergerWii Merger(*rkIsoPath.ToUTF16(), *pOriginalIso, IsTrilogy(), ProgressCallback);
-    return Merger.mergeFromDirectory(*DiscRoot) == nod::EBuildResult::Success;
+    if (!IsWiiBuild())
+    {
+        nod::DiscMergerGCN Merger(*rkIsoPath.ToUTF16(), *static_cast<nod::DiscGCN*>(pOriginalIso), ProgressCallback);
+        return Merger.mergeFromDirectory(*DiscRoot) == nod::EBuildResult::Success;
+    }
+    else
+    {
+        nod::DiscMergerWii Merger(*rkIsoPath.ToUTF16(), *static_cast<nod::DiscWii*>(pOriginalIso), IsTrilogy(), ProgressCallback);
+        return Merger.mergeFromDirectory(*DiscRoot) == nod::EBuildResult::Success;
+    }
 }
 
 void CGameProject::GetWorldList(std::list<CAssetID>& rOut) const
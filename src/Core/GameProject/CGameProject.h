@@ -5,6 +5,7 @@
 #include "CPackage.h"
 #include "CResourceStore.h"
 #include "Core/CAudioManager.h"
+#include "Core/CompressionUtil.h"
 #include "Core/IProgressNotifier.h"
 #include "Core/Resource/Script/CGameTemplate.h"
 #include <Common/CAssetID.h>
@@ -13,7 +14,7 @@
 #include <Common/TString.h>
 #include <Common/FileIO/CFileLock.h>
 
-namespace nod { class DiscWii; }
+namespace nod { class DiscBase; }
 
 enum class EProjectVersion
 {
@@ -32,6 +33,16 @@ class CGameProject
     TString mGameID;
     float mBuildVersion;
 
+    // Original disc image the project was exported from
+    TString mSourceDiscPath;
+
+    // If set, the Disc folder only holds the files the editor modifies, and everything else
+    // is streamed from the source disc image on build.
+    bool mStreamFromSourceDisc;
+
+    // Compression settings used when cooking packages
+    ECookProfile mCookProfile;
+
     TString mProjectRoot;
     std::vector<CPackage*> mPackages;
     CResourceStore *mpResourceStore;
@@ -49,6 +60,8 @@ class CGameProject
         , mRegion(ERegion::Unknown)
         , mGameID("000000")
         , mBuildVersion(0.f)
+        , mStreamFromSourceDisc(false)
+        , mCookProfile(ECookProfile::Max)
         , mpResourceStore(nullptr)
     {
         mpGameInfo = new CGameInfo();
@@ -62,7 +75,7 @@ public:
     bool Save();
     bool Serialize(IArchive& rArc);
     bool BuildISO(const TString& rkIsoPath, IProgressNotifier *pProgress);
-    bool MergeISO(const TString& rkIsoPath, nod::DiscWii *pOriginalIso, IProgressNotifier *pProgress);
+    bool MergeISO(const TString& rkIsoPath, nod::DiscBase *pOriginalIso, IProgressNotifier *pProgress);
     void GetWorldList(std::list<CAssetID>& rOut) const;
     CAssetID FindNamedResource(const TString& rkName) const;
     CPackage* FindPackage(const TString& rkName) const;
@@ -90,6 +103,9 @@ public:
 
     // Accessors
     inline void SetProjectName(const TString& rkName)   { mProjectName = rkName; }
+    inline void SetSourceDiscPath(const TString& rkPath){ mSourceDiscPath = rkPath; }
+    inline void SetStreamFromSourceDisc(bool Stream)    { mStreamFromSourceDisc = Stream; }
+    inline void SetCookProfile(ECookProfile Profile)    { mCookProfile = Profile; }
 
     inline TString Name() const                         { return mProjectName; }
     inline uint32 NumPackages() const                   { return mPackages.size(); }
@@ -102,9 +118,13 @@ public:
     inline ERegion Region() const                       { return mRegion; }
     inline TString GameID() const                       { return mGameID; }
     inline float BuildVersion() const                   { return mBuildVersion; }
+    inline TString SourceDiscPath() const               { return mSourceDiscPath; }
+    inline bool StreamsFromSourceDisc() const           { return mStreamFromSourceDisc; }
+    inline ECookProfile CookProfile() const             { return mCookProfile; }
     inline bool IsWiiBuild() const                      { return mBuildVersion >= 3.f; }
     inline bool IsTrilogy() const                       { return mGame <= EGame::Corruption && mBuildVersion >= 3.593f; }
     inline bool IsWiiDeAsobu() const                    { return mGame <= EGame::Corruption && mBuildVersion >= 3.570f && mBuildVersion < 3.593f; }
+    inline bool NeedsDiscMerge() const                  { return IsWiiDeAsobu() || IsTrilogy() || mStreamFromSourceDisc; }
 };
 
 #endif // CGAMEPROJECT_H
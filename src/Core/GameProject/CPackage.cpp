@@ -1,15 +1,85 @@
 #include "CPackage.h"
 #include "DependencyListBuilders.h"
+#include "CCookedBlobCache.h"
 #include "CGameProject.h"
 #include "Core/CompressionUtil.h"
 #include "Core/Resource/Cooker/CWorldCooker.h"
+#include <Common/CTimer.h>
 #include <Common/Macros.h>
 #include <Common/FileIO.h>
 #include <Common/FileUtil.h>
+#include <Common/Hash/CFNV1A.h>
 #include <Common/Serialization/XML.h>
+#include <codegen/EnumReflection.h>
+#include <map>
 
 using namespace tinyxml2;
 
+/** Cook cache format version; bump this whenever the file layout or the way assets are compressed changes */
+const uint32 gkCookCacheVersion = 2;
+
+/** Cook cache entry; describes the compressed data written for an asset the last time the package was cooked */
+struct SCookCacheEntry
+{
+    uint64 SourceHash;
+    uint32 UncompressedSize;
+    bool Compressed;
+    uint32 DataOffset;
+    uint32 DataSize;
+};
+
+/** Reads the entry table from a cook cache file. The compressed data itself is only read when it's reused. */
+static void LoadCookCacheIndex(CFileInStream& rFile, EGame Game, ECookProfile Profile, std::map<CAssetID, SCookCacheEntry>& rOut)
+{
+    if (!rFile.IsValid() || rFile.Size() < 0x14)
+        return;
+
+    uint32 Magic = rFile.ReadLong();
+    uint32 Version = rFile.ReadLong();
+    EGame CacheGame = (EGame) rFile.ReadLong();
+    ECookProfile CacheProfile = (ECookProfile) rFile.ReadLong();
+
+    if (Magic != FOURCC('PKCC') || Version != gkCookCacheVersion || CacheGame != Game || CacheProfile != Profile)
+    {
+        debugf("Package cook cache is out of date; discarding");
+        return;
+    }
+
+    // Smallest possible entry: 32-bit asset ID, source hash, uncompressed size, compressed flag, data size
+    const uint32 kMinEntrySize = 4 + 8 + 4 + 1 + 4;
+    const uint32 kFileSize = rFile.Size();
+    uint32 NumEntries = rFile.ReadLong();
+    EIDLength IDLength = CAssetID::GameIDLength(Game);
+
+    if (NumEntries > (kFileSize - rFile.Tell()) / kMinEntrySize)
+    {
+        warnf("Package cook cache is corrupt; discarding");
+        return;
+    }
+
+    for (uint32 EntryIdx = 0; EntryIdx < NumEntries; EntryIdx++)
+    {
+        CAssetID ID(rFile, IDLength);
+        SCookCacheEntry Entry;
+        Entry.SourceHash = rFile.ReadLongLong();
+        Entry.UncompressedSize = rFile.ReadLong();
+        Entry.Compressed = (rFile.ReadByte() != 0);
+        Entry.DataSize = rFile.ReadLong();
+        Entry.DataOffset = rFile.Tell();
+
+        // A truncated cache would otherwise have us allocating and seeking based on garbage
+        if (Entry.DataOffset > kFileSize || Entry.DataSize > kFileSize - Entry.DataOffset)
+        {
+            warnf("Package cook cache is truncated; discarding");
+            rOut.clear();
+            return;
+        }
+
+        rFile.Seek(Entry.DataSize, SEEK_CUR);
+        rOut[ID] = Entry;
+    }
+}
+
 bool CPackage::Load()
 {
     TString DefPath = DefinitionPath(false);
@@ -59,9 +129,11 @@ void CPackage::UpdateDependencyCache() const
     mCacheDirty = false;
 }
 
-void CPackage::Cook(IProgressNotifier *pProgress)
+void CPackage::Cook(IProgressNotifier *pProgress, CCookedBlobCache *pBlobCache /*= nullptr*/)
 {
     SCOPED_TIMER(CookPackage);
+    double StartTime = CTimer::GlobalTime();
+    ECookProfile Profile = mpProject->CookProfile();
 
     // Build asset list
     pProgress->Report(-1, -1, "Building dependency list");
@@ -153,6 +225,29 @@ void CPackage::Cook(IProgressNotifier *pProgress)
     Pak.WriteToBoundary(Alignment, 0);
     ResTableSize = Pak.Tell() - ResTableOffset;
 
+    // Open the cook cache. Compressed data for assets that haven't changed since the last cook is copied
+    // from here instead of being recompressed. The updated cache is written to a temp file as we go.
+    TString CachePath = CookCachePath(false);
+    TString NewCachePath = CachePath + ".tmp";
+    std::map<CAssetID, SCookCacheEntry> CacheEntries;
+    uint32 NumNewCacheEntries = 0;
+    uint32 NumReusedAssets = 0;
+
+    CFileInStream CacheFile(CachePath, EEndian::BigEndian);
+    LoadCookCacheIndex(CacheFile, Game, Profile, CacheEntries);
+
+    FileUtil::MakeDirectory(NewCachePath.GetFileDirectory());
+    CFileOutStream NewCacheFile(NewCachePath, EEndian::BigEndian);
+
+    if (NewCacheFile.IsValid())
+    {
+        NewCacheFile.WriteFourCC( FOURCC('PKCC') );
+        NewCacheFile.WriteLong(gkCookCacheVersion);
+        NewCacheFile.WriteLong((uint32) Game);
+        NewCacheFile.WriteLong((uint32) Profile);
+        NewCacheFile.WriteLong(0); // Entry count; written at the end
+    }
+
     // Start writing resources
     struct SResourceTableInfo
     {
@@ -177,6 +272,9 @@ void CPackage::Cook(IProgressNotifier *pProgress)
         {
             pProgress->Report(ResIdx, AssetList.size(), "Cooking asset: " + pEntry->Name() + "." + pEntry->CookedExtension());
             pEntry->Cook();
+
+            // The cooked file changed, so anything we remember about it is out of date
+            if (pBlobCache) pBlobCache->InvalidateAsset(ID);
         }
 
         // Update progress bar
@@ -190,14 +288,11 @@ void CPackage::Cook(IProgressNotifier *pProgress)
         rTableInfo.pEntry = pEntry;
         rTableInfo.Offset = (Game <= EGame::Echoes ? AssetOffset : AssetOffset - ResDataOffset);
 
-        // Load resource data
+        // Open resource data
         CFileInStream CookedAsset(pEntry->CookedAssetPath(), EEndian::BigEndian);
         ASSERT(CookedAsset.IsValid());
         uint32 ResourceSize = CookedAsset.Size();
 
-        std::vector<uint8> ResourceData(ResourceSize);
-        CookedAsset.ReadBytes(ResourceData.data(), ResourceData.size());
-
         // Check if this asset should be compressed; there are a few resource types that are
         // always compressed, and some types that are compressed if they're over a certain size
         EResourceType Type = pEntry->ResourceType();
@@ -223,7 +318,34 @@ void CPackage::Cook(IProgressNotifier *pProgress)
                  Type == EResourceType::ParticleSpawn || Type == EResourceType::ParticleSorted ||
                  Type == EResourceType::BurstFireData);
 
-        bool ShouldCompress = ShouldAlwaysCompress || (ShouldCompressConditional && ResourceSize >= CompressThreshold);
+        // The fast cook profile skips compression entirely; the game handles uncompressed assets of any type
+        bool ShouldCompress = (Profile != ECookProfile::Fast) &&
+                              (ShouldAlwaysCompress || (ShouldCompressConditional && ResourceSize >= CompressThreshold));
+
+        // If this asset was already compressed for another package during this run, and it hasn't been
+        // recooked since, the compressed data can be reused without reading the cooked file at all
+        CCookedBlobCache::SBlobKey BlobKey;
+        const CCookedBlobCache::SBlob *pkBlob = nullptr;
+
+        if (ShouldCompress && pBlobCache)
+        {
+            pkBlob = pBlobCache->FindAssetBlob(ID, BlobKey);
+
+            if (pkBlob && (!pkBlob->Compressed || BlobKey.SourceSize != ResourceSize || BlobKey.Profile != Profile))
+                pkBlob = nullptr;
+        }
+
+        std::vector<uint8> ResourceData;
+
+        if (!pkBlob)
+        {
+            ResourceData.resize(ResourceSize);
+            CookedAsset.ReadBytes(ResourceData.data(), ResourceData.size());
+        }
+        else
+            pBlobCache->RecordHit(BlobKey, *pkBlob, true);
+
+        CookedAsset.Close();
 
         // Write resource data to pak
         if (!ShouldCompress)
@@ -234,22 +356,110 @@ void CPackage::Cook(IProgressNotifier *pProgress)
 
         else
         {
-            uint32 CompressedSize;
-            std::vector<uint8> CompressedData(ResourceData.size() * 2);
+            uint32 CompressedSize = 0;
+            std::vector<uint8> CompressedData;
+            const uint8 *pkCompressedData = nullptr;
             bool Success = false;
+            bool IsZlib = (Game <= EGame::EchoesDemo || Game == EGame::DKCReturns);
+
+            if (pkBlob)
+            {
+                Success = true;
+                CompressedSize = pkBlob->Data.size();
+                pkCompressedData = pkBlob->Data.data();
+            }
 
-            if (Game <= EGame::EchoesDemo || Game == EGame::DKCReturns)
-                Success = CompressionUtil::CompressZlib(ResourceData.data(), ResourceData.size(), CompressedData.data(), CompressedData.size(), CompressedSize);
             else
-                Success = CompressionUtil::CompressLZOSegmented(ResourceData.data(), ResourceData.size(), CompressedData.data(), CompressedSize, false);
+            {
+                CFNV1A Hash(CFNV1A::k64Bit);
+                Hash.HashData(ResourceData.data(), ResourceData.size());
 
-            // Make sure that the compressed data is actually smaller, accounting for padding + uncompressed size value
-            if (Success)
+                BlobKey.SourceHash = Hash.GetHash64();
+                BlobKey.SourceSize = ResourceSize;
+                BlobKey.IsZlib = IsZlib;
+                BlobKey.Profile = Profile;
+
+                // Check whether an identical file was already compressed for another package during this run
+                if (pBlobCache)
+                {
+                    pkBlob = pBlobCache->FindBlob(BlobKey);
+
+                    if (pkBlob)
+                    {
+                        pBlobCache->SetAssetKey(ID, BlobKey);
+                        pBlobCache->RecordHit(BlobKey, *pkBlob, false);
+                        Success = pkBlob->Compressed;
+                        CompressedSize = pkBlob->Data.size();
+                        pkCompressedData = pkBlob->Data.data();
+                    }
+                }
+
+                if (!pkBlob)
+                {
+                    // Reuse the compressed data from the last cook if the cooked asset hasn't changed
+                    auto Find = CacheEntries.find(ID);
+                    double CompressTime = 0.0;
+
+                    if (Find != CacheEntries.end() && Find->second.SourceHash == BlobKey.SourceHash && Find->second.UncompressedSize == ResourceSize)
+                    {
+                        const SCookCacheEntry& rkCached = Find->second;
+                        Success = rkCached.Compressed;
+
+                        if (Success)
+                        {
+                            CompressedSize = rkCached.DataSize;
+                            CompressedData.resize(CompressedSize);
+                            CacheFile.Seek(rkCached.DataOffset, SEEK_SET);
+                            CacheFile.ReadBytes(CompressedData.data(), CompressedSize);
+                        }
+
+                        NumReusedAssets++;
+                    }
+
+                    else
+                    {
+                        double CompressStart = CTimer::GlobalTime();
+
+                        if (IsZlib)
+                        {
+                            CompressedData.resize( CompressionUtil::CompressSegmentBound(ResourceData.size(), true) );
+                            Success = CompressionUtil::CompressZlib(ResourceData.data(), ResourceData.size(), CompressedData.data(), CompressedData.size(), CompressedSize, Profile);
+                        }
+                        else
+                        {
+                            CompressedData.resize( CompressionUtil::CompressSegmentedBound(ResourceData.size(), false, false) );
+                            Success = CompressionUtil::CompressLZOSegmented(ResourceData.data(), ResourceData.size(), CompressedData.data(), CompressedSize, false, Profile);
+                        }
+
+                        // Make sure that the compressed data is actually smaller, accounting for padding + uncompressed size value
+                        if (Success)
+                        {
+                            uint32 CompressionHeaderSize = (Game <= EGame::CorruptionProto ? 4 : 0x10);
+                            uint32 PaddedUncompressedSize = (ResourceSize + AlignmentMinusOne) & ~AlignmentMinusOne;
+                            uint32 PaddedCompressedSize = (CompressedSize + CompressionHeaderSize + AlignmentMinusOne) & ~AlignmentMinusOne;
+                            Success = (PaddedCompressedSize < PaddedUncompressedSize);
+                        }
+
+                        CompressTime = CTimer::GlobalTime() - CompressStart;
+                    }
+
+                    pkCompressedData = CompressedData.data();
+
+                    if (pBlobCache)
+                        pBlobCache->AddBlob(ID, BlobKey, Success, CompressedData.data(), CompressedSize, CompressTime);
+                }
+            }
+
+            // Record the result in the new cook cache
+            if (NewCacheFile.IsValid())
             {
-                uint32 CompressionHeaderSize = (Game <= EGame::CorruptionProto ? 4 : 0x10);
-                uint32 PaddedUncompressedSize = (ResourceSize + AlignmentMinusOne) & ~AlignmentMinusOne;
-                uint32 PaddedCompressedSize = (CompressedSize + CompressionHeaderSize + AlignmentMinusOne) & ~AlignmentMinusOne;
-                Success = (PaddedCompressedSize < PaddedUncompressedSize);
+                ID.Write(NewCacheFile);
+                NewCacheFile.WriteLongLong(BlobKey.SourceHash);
+                NewCacheFile.WriteLong(ResourceSize);
+                NewCacheFile.WriteByte(Success ? 1 : 0);
+                NewCacheFile.WriteLong(Success ? CompressedSize : 0);
+                if (Success) NewCacheFile.WriteBytes(pkCompressedData, CompressedSize);
+                NumNewCacheEntries++;
             }
 
             // Write file to pak
@@ -272,7 +482,7 @@ void CPackage::Cook(IProgressNotifier *pProgress)
                     Pak.WriteLong(0xA0000000 | CompressedSize);
                     Pak.WriteLong(ResourceSize);
                 }
-                Pak.WriteBytes(CompressedData.data(), CompressedSize);
+                Pak.WriteBytes(pkCompressedData, CompressedSize);
             }
             else
                 Pak.WriteBytes(ResourceData.data(), ResourceSize);
@@ -284,6 +494,7 @@ void CPackage::Cook(IProgressNotifier *pProgress)
         rTableInfo.Size = Pak.Tell() - AssetOffset;
     }
     ResDataSize = Pak.Tell() - ResDataOffset;
+    CacheFile.Close();
 
     // If we cancelled, don't finish writing the pak; delete the file instead and make sure the package is flagged for recook
     if (pProgress->ShouldCancel())
@@ -291,6 +502,10 @@ void CPackage::Cook(IProgressNotifier *pProgress)
         Pak.Close();
         FileUtil::DeleteFile(PakPath);
         mNeedsRecook = true;
+
+        // The old cook cache is still valid, so keep it
+        NewCacheFile.Close();
+        FileUtil::DeleteFile(NewCachePath);
     }
 
     else
@@ -323,9 +538,24 @@ void CPackage::Cook(IProgressNotifier *pProgress)
             Pak.WriteLong(rkInfo.Offset);
         }
 
+        // Replace the old cook cache
+        if (NewCacheFile.IsValid())
+        {
+            NewCacheFile.Seek(0x10, SEEK_SET);
+            NewCacheFile.WriteLong(NumNewCacheEntries);
+            NewCacheFile.Close();
+
+            FileUtil::DeleteFile(CachePath);
+
+            if (!FileUtil::MoveFile(NewCachePath, CachePath))
+                warnf("Failed to update cook cache for %s", *Name());
+        }
+
         // Clear recook flag
         mNeedsRecook = false;
-        debugf("Finished writing %s", *PakPath);
+        debugf("Finished writing %s; reused compressed data for %d assets", *PakPath, NumReusedAssets);
+        debugf("Cooked %s.pak with %s profile: %d bytes in %.2fs", *Name(), TEnumReflection<ECookProfile>::ConvertValueToString(Profile),
+               ResDataOffset + ResDataSize, CTimer::GlobalTime() - StartTime);
     }
 
     Save();
@@ -447,6 +677,12 @@ TString CPackage::DefinitionPath(bool Relative) const
     return Relative ? RelPath : mpProject->PackagesDir(false) + RelPath;
 }
 
+TString CPackage::CookCachePath(bool Relative) const
+{
+    TString RelPath = mPakPath + mPakName + ".pcc";
+    return Relative ? RelPath : mpProject->PackagesDir(false) + RelPath;
+}
+
 TString CPackage::CookedPackagePath(bool Relative) const
 {
     TString RelPath = mPakPath + mPakName + ".pak";
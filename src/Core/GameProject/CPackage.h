@@ -7,6 +7,7 @@
 #include <Common/Serialization/IArchive.h>
 #include "Core/IProgressNotifier.h"
 
+class CCookedBlobCache;
 class CGameProject;
 
 enum class EPackageDefinitionVersion
@@ -61,12 +62,13 @@ public:
     void AddResource(const TString& rkName, const CAssetID& rkID, const CFourCC& rkType);
     void UpdateDependencyCache() const;
 
-    void Cook(IProgressNotifier *pProgress);
+    void Cook(IProgressNotifier *pProgress, CCookedBlobCache *pBlobCache = nullptr);
     void CompareOriginalAssetList(const std::list<CAssetID>& rkNewList);
     bool ContainsAsset(const CAssetID& rkID) const;
 
     TString DefinitionPath(bool Relative) const;
     TString CookedPackagePath(bool Relative) const;
+    TString CookCachePath(bool Relative) const;
 
     // Accessors
     inline TString Name() const                                         { return mPakName; }
@@ -9,6 +9,11 @@
 #include <Common/TString.h>
 #include <Common/Serialization/CXMLReader.h>
 #include <Common/Serialization/CXMLWriter.h>
+#include <atomic>
+
+/** Source for dependency versions. Every version handed out is unique, so an entry that's deleted
+ *  and recreated with the same ID never matches a version recorded for the old entry. */
+static std::atomic<uint32> gDependencyVersionCounter(0);
 
 CResourceEntry::CResourceEntry(CResourceStore *pStore)
     : mpResource(nullptr)
@@ -17,6 +22,7 @@ CResourceEntry::CResourceEntry(CResourceStore *pStore)
     , mpDependencies(nullptr)
     , mID( CAssetID::InvalidID(pStore->Game()) )
     , mpDirectory(nullptr)
+    , mDependencyVersion(++gDependencyVersionCounter)
     , mMetadataDirty(false)
     , mCachedSize(-1)
 {}
@@ -146,6 +152,7 @@ void CResourceEntry::SerializeEntryInfo(IArchive& rArc, bool MetadataOnly)
 
         if (rArc.IsReader())
         {
+            mDependencyVersion = ++gDependencyVersionCounter;
             mpDirectory = mpStore->GetVirtualDirectory(Dir, true);
             mpDirectory->AddChild("", this);
             mCachedUppercaseName = mName.ToUpper();
@@ -155,6 +162,8 @@ void CResourceEntry::SerializeEntryInfo(IArchive& rArc, bool MetadataOnly)
 
 void CResourceEntry::UpdateDependencies()
 {
+    mDependencyVersion = ++gDependencyVersionCounter;
+
     if (mpDependencies)
     {
         delete mpDependencies;
@@ -254,8 +263,9 @@ bool CResourceEntry::NeedsRecook() const
 {
     // Assets that do not have a raw version can't be recooked since they will always just be saved cooked to begin with.
     // We will recook any asset where the raw version has been updated but not recooked yet. eREF_NeedsRecook can also be
-    // toggled to arbitrarily flag any asset for recook.
-    if (!HasRawVersion()) return false;
+    // toggled to arbitrarily flag any asset for recook. Cook-only types are cooked whenever they're saved, so for those
+    // the flag is only honored when we made the cooked file ourselves; base game files are left as they are.
+    if (!HasRawVersion()) return HasFlag(EResEntryFlag::NeedsRecook) && HasFlag(EResEntryFlag::HasBeenModified);
     if (!HasCookedVersion()) return true;
     if (HasFlag(EResEntryFlag::NeedsRecook)) return true;
     return (FileUtil::LastModifiedTime(CookedAssetPath()) < FileUtil::LastModifiedTime(RawAssetPath()));
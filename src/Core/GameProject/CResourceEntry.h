@@ -34,6 +34,7 @@ class CResourceEntry
     CVirtualDirectory *mpDirectory;
     TString mName;
     FResEntryFlags mFlags;
+    uint32 mDependencyVersion; // Changes whenever the dependency tree is rebuilt
 
     mutable bool mMetadataDirty;
     mutable uint64 mCachedSize;
@@ -98,6 +99,7 @@ public:
     inline CResTypeInfo* TypeInfo() const           { return mpTypeInfo; }
     inline CResourceStore* ResourceStore() const    { return mpStore; }
     inline CDependencyTree* Dependencies() const    { return mpDependencies; }
+    inline uint32 DependencyVersion() const         { return mDependencyVersion; }
     inline CAssetID ID() const                      { return mID; }
     inline CVirtualDirectory* Directory() const     { return mpDirectory; }
     inline TString DirectoryPath() const            { return mpDirectory->FullPath(); }
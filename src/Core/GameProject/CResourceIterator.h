@@ -9,20 +9,33 @@ class CResourceIterator
 protected:
     const CResourceStore *mpkStore;
     std::map<CAssetID, CResourceEntry*>::const_iterator mIter;
+    std::map<CAssetID, CResourceEntry*>::const_iterator mEnd;
     CResourceEntry *mpCurEntry;
 
+    // Iterates only over entries of the given type, using the store's per-type entry lists
+    CResourceIterator(const CResourceStore *pkStore, EResourceType Type)
+        : mpkStore(pkStore)
+        , mpCurEntry(nullptr)
+    {
+        const std::map<CAssetID, CResourceEntry*>& rkEntries = mpkStore->EntriesOfType(Type);
+        mIter = rkEntries.begin();
+        mEnd = rkEntries.end();
+        Next();
+    }
+
 public:
     CResourceIterator(const CResourceStore *pkStore = gpResourceStore)
         : mpkStore(pkStore)
         , mpCurEntry(nullptr)
     {
         mIter = mpkStore->mResourceEntries.begin();
+        mEnd = mpkStore->mResourceEntries.end();
         Next();
     }
 
     virtual CResourceEntry* Next()
     {
-        if (mIter != mpkStore->mResourceEntries.end())
+        if (mIter != mEnd)
         {
             mpCurEntry = mIter->second;
             mIter++;
@@ -71,19 +84,8 @@ class TResourceIterator : public CResourceIterator
 {
 public:
     TResourceIterator(CResourceStore *pStore = gpResourceStore)
-        : CResourceIterator(pStore)
+        : CResourceIterator(pStore, ResType)
     {
-        if (mpCurEntry && mpCurEntry->ResourceType() != ResType)
-            Next();
-    }
-
-    virtual CResourceEntry* Next()
-    {
-        do {
-            CResourceIterator::Next();
-        } while (mpCurEntry && mpCurEntry->ResourceType() != ResType);
-
-        return mpCurEntry;
     }
 };
 
@@ -15,6 +15,30 @@ using namespace tinyxml2;
 CResourceStore *gpResourceStore = nullptr;
 CResourceStore *gpEditorStore = nullptr;
 
+void CResourceStore::AddEntry(CResourceEntry *pEntry)
+{
+    mResourceEntries[pEntry->ID()] = pEntry;
+    mTypeEntries[pEntry->ResourceType()][pEntry->ID()] = pEntry;
+}
+
+void CResourceStore::RemoveEntry(CResourceEntry *pEntry)
+{
+    auto It = mResourceEntries.find(pEntry->ID());
+    ASSERT(It != mResourceEntries.end());
+    mResourceEntries.erase(It);
+
+    auto TypeIt = mTypeEntries.find(pEntry->ResourceType());
+    ASSERT(TypeIt != mTypeEntries.end());
+    TypeIt->second.erase(pEntry->ID());
+}
+
+const std::map<CAssetID, CResourceEntry*>& CResourceStore::EntriesOfType(EResourceType Type) const
+{
+    static const std::map<CAssetID, CResourceEntry*> skEmptyMap;
+    auto Find = mTypeEntries.find(Type);
+    return (Find == mTypeEntries.end() ? skEmptyMap : Find->second);
+}
+
 // Constructor for editor store
 CResourceStore::CResourceStore(const TString& rkDatabasePath)
     : mpProj(nullptr)
@@ -76,7 +100,7 @@ bool CResourceStore::SerializeDatabaseCache(IArchive& rArc)
                 {
                     CResourceEntry *pEntry = CResourceEntry::BuildFromArchive(this, rArc);
                     ASSERT( FindEntry(pEntry->ID()) == nullptr );
-                    mResourceEntries[pEntry->ID()] = pEntry;
+                    AddEntry(pEntry);
                     rArc.ParamEnd();
                 }
             }
@@ -214,6 +238,7 @@ void CResourceStore::CloseProject()
         delete It->second;
         It = mResourceEntries.erase(It);
     }
+    mTypeEntries.clear();
 
     delete mpDatabaseRoot;
     mpDatabaseRoot = nullptr;
@@ -269,6 +294,11 @@ CResourceEntry* CResourceStore::FindEntry(const TString& rkPath) const
     return (mpDatabaseRoot ? mpDatabaseRoot->FindChildResource(rkPath) : nullptr);
 }
 
+uint32 CResourceStore::NumResourcesOfType(EResourceType Type) const
+{
+    return EntriesOfType(Type).size();
+}
+
 bool CResourceStore::AreAllEntriesValid() const
 {
     for (CResourceIterator Iter(this); Iter; ++Iter)
@@ -290,6 +320,7 @@ void CResourceStore::ClearDatabase()
     for (auto Iter = mResourceEntries.begin(); Iter != mResourceEntries.end(); Iter++)
         delete Iter->second;
     mResourceEntries.clear();
+    mTypeEntries.clear();
 
     delete mpDatabaseRoot;
     mpDatabaseRoot = new CVirtualDirectory(this);
@@ -337,7 +368,7 @@ bool CResourceStore::BuildFromDirectory(bool ShouldGenerateCacheFile)
             ASSERT( mResourceEntries.find(ID) == mResourceEntries.end() );
             ASSERT( ID.Length() == CAssetID::GameIDLength(mGame) );
 
-            mResourceEntries[ID] = pEntry;
+            AddEntry(pEntry);
         }
 
         else if (FileUtil::IsDirectory(Path))
@@ -397,7 +428,7 @@ CResourceEntry* CResourceStore::RegisterResource(const CAssetID& rkID, EResource
         if (IsValidResourcePath(rkDir, rkName))
         {
             pEntry = CResourceEntry::CreateNewResource(this, rkID, rkDir, rkName, Type);
-            mResourceEntries[rkID] = pEntry;
+            AddEntry(pEntry);
         }
 
         else
@@ -526,10 +557,7 @@ bool CResourceStore::DeleteResourceEntry(CResourceEntry *pEntry)
     if (pEntry->Directory())
         pEntry->Directory()->RemoveChildResource(pEntry);
 
-    auto It = mResourceEntries.find(ID);
-    ASSERT(It != mResourceEntries.end());
-    mResourceEntries.erase(It);
-
+    RemoveEntry(pEntry);
     delete pEntry;
     return true;
 }
@@ -9,6 +9,7 @@
 #include <Common/TString.h>
 #include <map>
 #include <set>
+#include <unordered_map>
 
 class CGameExporter;
 class CGameProject;
@@ -32,11 +33,16 @@ class CResourceStore
     CVirtualDirectory *mpDatabaseRoot;
     std::map<CAssetID, CResourceEntry*> mResourceEntries;
     std::map<CAssetID, CResourceEntry*> mLoadedResources;
+    std::unordered_map<EResourceType, std::map<CAssetID, CResourceEntry*>> mTypeEntries;
     bool mDatabaseCacheDirty;
 
     // Directory paths
     TString mDatabasePath;
 
+    void AddEntry(CResourceEntry *pEntry);
+    void RemoveEntry(CResourceEntry *pEntry);
+    const std::map<CAssetID, CResourceEntry*>& EntriesOfType(EResourceType Type) const;
+
 public:
     CResourceStore(const TString& rkDatabasePath);
     CResourceStore(CGameProject *pProject);
@@ -57,6 +63,7 @@ public:
     CResourceEntry* RegisterResource(const CAssetID& rkID, EResourceType Type, const TString& rkDir, const TString& rkName);
     CResourceEntry* FindEntry(const CAssetID& rkID) const;
     CResourceEntry* FindEntry(const TString& rkPath) const;
+    uint32 NumResourcesOfType(EResourceType Type) const;
     bool AreAllEntriesValid() const;
     void ClearDatabase();
     bool BuildFromDirectory(bool ShouldGenerateCacheFile);
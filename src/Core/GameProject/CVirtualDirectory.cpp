@@ -18,6 +18,7 @@ CVirtualDirectory::CVirtualDirectory(CVirtualDirectory *pParent, const TString&
     : mpParent(pParent), mName(rkName), mpStore(pStore)
 {
     ASSERT(!mName.IsEmpty() && FileUtil::IsValidName(mName, true));
+    UpdateFullPath();
 }
 
 CVirtualDirectory::~CVirtualDirectory()
@@ -46,14 +47,6 @@ bool CVirtualDirectory::IsDescendantOf(CVirtualDirectory *pDir) const
     return (this == pDir) || (mpParent && pDir && (mpParent == pDir || mpParent->IsDescendantOf(pDir)));
 }
 
-TString CVirtualDirectory::FullPath() const
-{
-    if (IsRoot())
-        return "";
-    else
-        return (mpParent ? mpParent->FullPath() + mName : mName) + '/';
-}
-
 TString CVirtualDirectory::AbsolutePath() const
 {
     return mpStore->ResourcesDir() + FullPath();
@@ -68,25 +61,21 @@ CVirtualDirectory* CVirtualDirectory::FindChildDirectory(const TString& rkName,
 {
     uint32 SlashIdx = rkName.IndexOf("\\/");
     TString DirName = (SlashIdx == -1 ? rkName : rkName.SubString(0, SlashIdx));
+    CVirtualDirectory *pChild = FindSubdirectory(DirName, false);
 
-    for (uint32 iSub = 0; iSub < mSubdirectories.size(); iSub++)
+    if (pChild)
     {
-        CVirtualDirectory *pChild = mSubdirectories[iSub];
+        if (SlashIdx == -1)
+            return pChild;
 
-        if (pChild->Name().CaseInsensitiveCompare(DirName))
+        else
         {
-            if (SlashIdx == -1)
-                return pChild;
+            TString Remaining = rkName.SubString(SlashIdx + 1, rkName.Size() - SlashIdx);
 
+            if (Remaining.IsEmpty())
+                return pChild;
             else
-            {
-                TString Remaining = rkName.SubString(SlashIdx + 1, rkName.Size() - SlashIdx);
-
-                if (Remaining.IsEmpty())
-                    return pChild;
-                else
-                    return pChild->FindChildDirectory(Remaining, AllowCreate);
-            }
+                return pChild->FindChildDirectory(Remaining, AllowCreate);
         }
     }
 
@@ -155,16 +144,7 @@ bool CVirtualDirectory::AddChild(const TString &rkPath, CResourceEntry *pEntry)
         TString Remaining = (SlashIdx == -1 ? "" : rkPath.SubString(SlashIdx + 1, rkPath.Size() - SlashIdx));
 
         // Check if this subdirectory already exists
-        CVirtualDirectory *pSubdir = nullptr;
-
-        for (uint32 iSub = 0; iSub < mSubdirectories.size(); iSub++)
-        {
-            if (mSubdirectories[iSub]->Name() == DirName)
-            {
-                pSubdir = mSubdirectories[iSub];
-                break;
-            }
-        }
+        CVirtualDirectory *pSubdir = FindSubdirectory(DirName, true);
 
         if (!pSubdir)
         {
@@ -177,7 +157,7 @@ bool CVirtualDirectory::AddChild(const TString &rkPath, CResourceEntry *pEntry)
                 return false;
             }
 
-            mSubdirectories.push_back(pSubdir);
+            AddSubdirectory(pSubdir);
             SortSubdirectories();
 
             // As an optimization, don't recurse here. We've already verified the full path is valid, so we don't need to do it again.
@@ -194,7 +174,7 @@ bool CVirtualDirectory::AddChild(const TString &rkPath, CResourceEntry *pEntry)
                     return false;
                 }
 
-                pSubdir->Parent()->mSubdirectories.push_back(pSubdir);
+                pSubdir->Parent()->AddSubdirectory(pSubdir);
             }
 
             if (pEntry)
@@ -219,9 +199,9 @@ bool CVirtualDirectory::AddChild(const TString &rkPath, CResourceEntry *pEntry)
 bool CVirtualDirectory::AddChild(CVirtualDirectory *pDir)
 {
     if (pDir->Parent() != this) return false;
-    if (FindChildDirectory(pDir->Name(), false) != nullptr) return false;
+    if (FindSubdirectory(pDir->Name(), false) != nullptr) return false;
 
-    mSubdirectories.push_back(pDir);
+    AddSubdirectory(pDir);
     SortSubdirectories();
 
     return true;
@@ -234,6 +214,7 @@ bool CVirtualDirectory::RemoveChildDirectory(CVirtualDirectory *pSubdir)
         if (*It == pSubdir)
         {
             mSubdirectories.erase(It);
+            RemoveSubdirectoryKey(pSubdir);
             return true;
         }
     }
@@ -275,7 +256,10 @@ bool CVirtualDirectory::Rename(const TString& rkNewName)
 
             if (FileUtil::MoveDirectory(AbsPath, NewPath))
             {
+                mpParent->RemoveSubdirectoryKey(this);
                 mName = rkNewName;
+                mpParent->mSubdirectoryMap[mName] = this;
+                UpdateFullPath();
                 mpStore->SetCacheDirty();
                 mpParent->SortSubdirectories();
                 return true;
@@ -363,6 +347,7 @@ bool CVirtualDirectory::SetParent(CVirtualDirectory *pParent)
     if (mpParent->RemoveChildDirectory(this) && FileUtil::MoveDirectory(AbsOldPath, AbsNewPath))
     {
         mpParent = pParent;
+        UpdateFullPath();
         mpParent->AddChild(this);
         mpStore->SetCacheDirty();
         return true;
@@ -375,6 +360,50 @@ bool CVirtualDirectory::SetParent(CVirtualDirectory *pParent)
     }
 }
 
+// ************ PRIVATE ************
+void CVirtualDirectory::AddSubdirectory(CVirtualDirectory *pSubdir)
+{
+    mSubdirectories.push_back(pSubdir);
+    mSubdirectoryMap[pSubdir->Name()] = pSubdir;
+}
+
+void CVirtualDirectory::RemoveSubdirectoryKey(CVirtualDirectory *pSubdir)
+{
+    auto Find = mSubdirectoryMap.find(pSubdir->Name());
+
+    if (Find != mSubdirectoryMap.end() && Find->second == pSubdir)
+        mSubdirectoryMap.erase(Find);
+}
+
+CVirtualDirectory* CVirtualDirectory::FindSubdirectory(const TString& rkName, bool CaseSensitive) const
+{
+    auto Find = mSubdirectoryMap.find(rkName);
+
+    if (Find != mSubdirectoryMap.end())
+        return Find->second;
+
+    // Names usually match exactly, so only fall back to scanning for case-insensitive lookups
+    if (!CaseSensitive)
+    {
+        for (uint32 SubIdx = 0; SubIdx < mSubdirectories.size(); SubIdx++)
+        {
+            if (mSubdirectories[SubIdx]->Name().CaseInsensitiveCompare(rkName))
+                return mSubdirectories[SubIdx];
+        }
+    }
+
+    return nullptr;
+}
+
+void CVirtualDirectory::UpdateFullPath()
+{
+    // Paths are cached since they're requested constantly; they only change when a directory is renamed or moved
+    mFullPath = (IsRoot() ? "" : mpParent->FullPath() + mName + '/');
+
+    for (uint32 SubIdx = 0; SubIdx < mSubdirectories.size(); SubIdx++)
+        mSubdirectories[SubIdx]->UpdateFullPath();
+}
+
 // ************ STATIC ************
 bool CVirtualDirectory::IsValidDirectoryName(const TString& rkName)
 {
@@ -5,6 +5,7 @@
 #include "Core/Resource/EResType.h"
 #include <Common/Macros.h>
 #include <Common/TString.h>
+#include <unordered_map>
 #include <vector>
 
 class CResourceEntry;
@@ -12,12 +13,25 @@ class CResourceStore;
 
 class CVirtualDirectory
 {
+    /** Hasher for subdirectory names. Names are stored as-is, so sibling directories that only differ by case get separate keys. */
+    struct SNameHash
+    {
+        inline size_t operator()(const TString& rkName) const  { return rkName.Hash32(); }
+    };
+
     CVirtualDirectory *mpParent;
     CResourceStore *mpStore;
     TString mName;
+    TString mFullPath;
     std::vector<CVirtualDirectory*> mSubdirectories;
+    std::unordered_map<TString, CVirtualDirectory*, SNameHash> mSubdirectoryMap;
     std::vector<CResourceEntry*> mResources;
 
+    void AddSubdirectory(CVirtualDirectory *pSubdir);
+    void RemoveSubdirectoryKey(CVirtualDirectory *pSubdir);
+    CVirtualDirectory* FindSubdirectory(const TString& rkName, bool CaseSensitive) const;
+    void UpdateFullPath();
+
 public:
     CVirtualDirectory(CResourceStore *pStore);
     CVirtualDirectory(const TString& rkName, CResourceStore *pStore);
@@ -26,7 +40,6 @@ public:
 
     bool IsEmpty(bool CheckFilesystem) const;
     bool IsDescendantOf(CVirtualDirectory *pDir) const;
-    TString FullPath() const;
     TString AbsolutePath() const;
     CVirtualDirectory* GetRoot();
     CVirtualDirectory* FindChildDirectory(const TString& rkName, bool AllowCreate);
@@ -50,6 +63,7 @@ public:
     inline CVirtualDirectory* Parent() const    { return mpParent; }
     inline bool IsRoot() const                  { return !mpParent; }
     inline TString Name() const                 { return mName; }
+    inline const TString& FullPath() const      { return mFullPath; }
 
     inline uint32 NumSubdirectories() const                         { return mSubdirectories.size(); }
     inline CVirtualDirectory* SubdirectoryByIndex(uint32 Index)     { return mSubdirectories[Index]; }
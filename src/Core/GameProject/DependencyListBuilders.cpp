@@ -1,4 +1,5 @@
 #include "DependencyListBuilders.h"
+#include <mutex>
 
 // ************ CCharacterUsageMap ************
 bool CCharacterUsageMap::IsCharacterUsed(const CAssetID& rkID, uint32 CharacterIndex) const
@@ -378,7 +379,78 @@ void CPackageDependencyListBuilder::FindUniversalAreaAssets()
 }
 
 // ************ CAreaDependencyListBuilder ************
+/** Cached dependency list for an area, along with the versions of the entries it was built from */
+struct SCachedAreaDependencies
+{
+    std::vector< std::pair<CAssetID, uint32> > VisitedEntries;
+    std::list<CAssetID> Assets;
+    std::list<uint32> LayerOffsets;
+    std::set<CAssetID> AudioGroups;
+};
+static std::map<CAssetID, SCachedAreaDependencies> gAreaDependencyCache;
+static std::mutex gAreaDependencyCacheMutex;
+
+/** Returns whether none of the entries the cached list was built from have changed. Missing entries are recorded as version 0. */
+static bool IsAreaDependencyCacheValid(CResourceStore *pStore, const SCachedAreaDependencies& rkCache)
+{
+    for (uint32 EntryIdx = 0; EntryIdx < rkCache.VisitedEntries.size(); EntryIdx++)
+    {
+        const std::pair<CAssetID, uint32>& rkVisited = rkCache.VisitedEntries[EntryIdx];
+        CResourceEntry *pEntry = pStore->FindEntry(rkVisited.first);
+        uint32 Version = (pEntry ? pEntry->DependencyVersion() : 0);
+
+        if (Version != rkVisited.second)
+            return false;
+    }
+
+    return true;
+}
+
 void CAreaDependencyListBuilder::BuildDependencyList(std::list<CAssetID>& rAssetsOut, std::list<uint32>& rLayerOffsetsOut, std::set<CAssetID> *pAudioGroupsOut)
+{
+    uint32 BaseOffset = rAssetsOut.size();
+    SCachedAreaDependencies Result;
+    bool FoundCachedResult = false;
+
+    {
+        std::lock_guard<std::mutex> Lock(gAreaDependencyCacheMutex);
+        auto Find = gAreaDependencyCache.find(mpAreaEntry->ID());
+
+        if (Find != gAreaDependencyCache.end() && IsAreaDependencyCacheValid(mpStore, Find->second))
+        {
+            Result = Find->second;
+            FoundCachedResult = true;
+        }
+    }
+
+    // Cache miss; evaluate the area. Audio groups are always collected so the cached result works for every caller.
+    if (!FoundCachedResult)
+    {
+        mVisitedEntries.clear();
+        mVisitedEntries[mpAreaEntry->ID()] = mpAreaEntry->DependencyVersion();
+        BuildDependencyListInternal(Result.Assets, Result.LayerOffsets, &Result.AudioGroups);
+        Result.VisitedEntries.assign(mVisitedEntries.begin(), mVisitedEntries.end());
+
+        std::lock_guard<std::mutex> Lock(gAreaDependencyCacheMutex);
+        gAreaDependencyCache[mpAreaEntry->ID()] = Result;
+    }
+
+    rAssetsOut.insert(rAssetsOut.end(), Result.Assets.begin(), Result.Assets.end());
+
+    for (auto Iter = Result.LayerOffsets.begin(); Iter != Result.LayerOffsets.end(); Iter++)
+        rLayerOffsetsOut.push_back(BaseOffset + *Iter);
+
+    if (pAudioGroupsOut)
+        pAudioGroupsOut->insert(Result.AudioGroups.begin(), Result.AudioGroups.end());
+}
+
+void CAreaDependencyListBuilder::ClearCache()
+{
+    std::lock_guard<std::mutex> Lock(gAreaDependencyCacheMutex);
+    gAreaDependencyCache.clear();
+}
+
+void CAreaDependencyListBuilder::BuildDependencyListInternal(std::list<CAssetID>& rAssetsOut, std::list<uint32>& rLayerOffsetsOut, std::set<CAssetID> *pAudioGroupsOut)
 {
     CAreaDependencyTree *pTree = static_cast<CAreaDependencyTree*>(mpAreaEntry->Dependencies());
 
@@ -462,6 +534,7 @@ void CAreaDependencyListBuilder::BuildDependencyList(std::list<CAssetID>& rAsset
 void CAreaDependencyListBuilder::AddDependency(const CAssetID& rkID, std::list<CAssetID>& rOut, std::set<CAssetID> *pAudioGroupsOut)
 {
     CResourceEntry *pEntry = mpStore->FindEntry(rkID);
+    mVisitedEntries.emplace(rkID, pEntry ? pEntry->DependencyVersion() : 0);
     if (!pEntry) return;
 
     EResourceType ResType = pEntry->ResourceType();
@@ -7,11 +7,20 @@
 #include "CResourceEntry.h"
 #include "Core/Resource/CDependencyGroup.h"
 #include "Core/Resource/CWorld.h"
+#include <unordered_map>
+#include <unordered_set>
+
+/** Hasher for asset IDs for use in unordered containers */
+struct SAssetIDHash
+{
+    inline size_t operator()(const CAssetID& rkID) const    { return std::hash<uint64>()(rkID.ToLongLong()); }
+};
+typedef std::unordered_set<CAssetID, SAssetIDHash> TAssetIDSet;
 
 class CCharacterUsageMap
 {
-    std::map<CAssetID, std::vector<bool>> mUsageMap;
-    std::set<CAssetID> mStillLookingIDs;
+    std::unordered_map<CAssetID, std::vector<bool>, SAssetIDHash> mUsageMap;
+    TAssetIDSet mStillLookingIDs;
     CResourceStore *mpStore;
     uint32 mLayerIndex;
     bool mIsInitialArea;
@@ -44,9 +53,9 @@ class CPackageDependencyListBuilder
     TResPtr<CWorld> mpWorld;
     CAssetID mCurrentAnimSetID;
     CCharacterUsageMap mCharacterUsageMap;
-    std::set<CAssetID> mPackageUsedAssets;
-    std::set<CAssetID> mAreaUsedAssets;
-    std::set<CAssetID> mUniversalAreaAssets;
+    TAssetIDSet mPackageUsedAssets;
+    TAssetIDSet mAreaUsedAssets;
+    TAssetIDSet mUniversalAreaAssets;
     bool mEnableDuplicates;
     bool mCurrentAreaHasDuplicates;
     bool mIsUniversalAreaAsset;
@@ -77,10 +86,15 @@ class CAreaDependencyListBuilder
     EGame mGame;
     CAssetID mCurrentAnimSetID;
     CCharacterUsageMap mCharacterUsageMap;
-    std::set<CAssetID> mBaseUsedAssets;
-    std::set<CAssetID> mLayerUsedAssets;
+    TAssetIDSet mBaseUsedAssets;
+    TAssetIDSet mLayerUsedAssets;
     bool mIsPlayerActor;
 
+    // Dependency versions of every entry looked at while building the list; used to validate the cached result
+    std::unordered_map<CAssetID, uint32, SAssetIDHash> mVisitedEntries;
+
+    void BuildDependencyListInternal(std::list<CAssetID>& rAssetsOut, std::list<uint32>& rLayerOffsetsOut, std::set<CAssetID> *pAudioGroupsOut);
+
 public:
     CAreaDependencyListBuilder(CResourceEntry *pAreaEntry)
         : mpAreaEntry(pAreaEntry)
@@ -91,9 +105,14 @@ public:
         ASSERT(mpAreaEntry->ResourceType() == EResourceType::Area);
     }
 
+    /** Build the dependency list for the area. Results are cached per area and reused until the dependency tree of the
+     *  area or of anything it depends on is rebuilt. Only reads the resource store, so areas can be built in parallel. */
     void BuildDependencyList(std::list<CAssetID>& rAssetsOut, std::list<uint32>& rLayerOffsetsOut, std::set<CAssetID> *pAudioGroupsOut = nullptr);
     void AddDependency(const CAssetID& rkID, std::list<CAssetID>& rOut, std::set<CAssetID> *pAudioGroupsOut);
     void EvaluateDependencyNode(CResourceEntry *pCurEntry, IDependencyNode *pNode, std::list<CAssetID>& rOut, std::set<CAssetID> *pAudioGroupsOut);
+
+    /** Discard all cached area dependency lists. Must be called when the resource store they were built from goes away. */
+    static void ClearCache();
 };
 
 #endif // DEPENDENCYLISTBUILDERS
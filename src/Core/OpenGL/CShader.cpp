@@ -121,6 +121,11 @@ bool CShader::LinkShaders()
     mProgram = glCreateProgram();
     glAttachShader(mProgram, mVertexShader);
     glAttachShader(mProgram, mPixelShader);
+
+    // Allow the linked program to be retrieved for the shader cache
+    if (ProgramBinariesSupported())
+        glProgramParameteri(mProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
     glLinkProgram(mProgram);
 
     glDeleteShader(mVertexShader);
@@ -156,17 +161,46 @@ bool CShader::LinkShaders()
         return false;
     }
 
-    mMVPBlockIndex = GetUniformBlockIndex("MVPBlock");
-    mVertexBlockIndex = GetUniformBlockIndex("VertexBlock");
-    mPixelBlockIndex = GetUniformBlockIndex("PixelBlock");
-    mLightBlockIndex = GetUniformBlockIndex("LightBlock");
-    mBoneTransformBlockIndex = GetUniformBlockIndex("BoneTransformBlock");
+    InitProgram();
+    return true;
+}
 
-    CacheCommonUniforms();
-    mProgramExists = true;
+bool CShader::LoadProgramBinary(GLenum Format, const void* pkData, uint32 Size)
+{
+    if (mProgramExists || !ProgramBinariesSupported()) return false;
+
+    mProgram = glCreateProgram();
+    glProgramBinary(mProgram, Format, pkData, Size);
+
+    // Binaries are rejected if the driver has changed since they were retrieved; this isn't an error
+    GLint LinkStatus;
+    glGetProgramiv(mProgram, GL_LINK_STATUS, &LinkStatus);
+
+    if (LinkStatus == GL_FALSE)
+    {
+        glDeleteProgram(mProgram);
+        return false;
+    }
+
+    InitProgram();
     return true;
 }
 
+bool CShader::GetProgramBinary(GLenum& rOutFormat, std::vector<uint8>& rOutData)
+{
+    if (!mProgramExists || !ProgramBinariesSupported()) return false;
+
+    GLint BinaryLength = 0;
+    glGetProgramiv(mProgram, GL_PROGRAM_BINARY_LENGTH, &BinaryLength);
+    if (BinaryLength <= 0) return false;
+
+    GLsizei ReturnedLength = 0;
+    rOutData.resize(BinaryLength);
+    glGetProgramBinary(mProgram, BinaryLength, &ReturnedLength, &rOutFormat, rOutData.data());
+    rOutData.resize(ReturnedLength);
+    return ReturnedLength > 0;
+}
+
 bool CShader::IsValidProgram()
 {
     return mProgramExists;
@@ -244,7 +278,38 @@ void CShader::KillCachedShader()
     spCurrentShader = 0;
 }
 
+bool CShader::ProgramBinariesSupported()
+{
+    static bool sChecked = false;
+    static bool sSupported = false;
+
+    if (!sChecked)
+    {
+        GLint NumFormats = 0;
+
+        if (GLEW_ARB_get_program_binary)
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &NumFormats);
+
+        sSupported = (NumFormats > 0);
+        sChecked = true;
+    }
+
+    return sSupported;
+}
+
 // ************ PRIVATE ************
+void CShader::InitProgram()
+{
+    mMVPBlockIndex = GetUniformBlockIndex("MVPBlock");
+    mVertexBlockIndex = GetUniformBlockIndex("VertexBlock");
+    mPixelBlockIndex = GetUniformBlockIndex("PixelBlock");
+    mLightBlockIndex = GetUniformBlockIndex("LightBlock");
+    mBoneTransformBlockIndex = GetUniformBlockIndex("BoneTransformBlock");
+
+    CacheCommonUniforms();
+    mProgramExists = true;
+}
+
 void CShader::CacheCommonUniforms()
 {
     for (uint32 iTex = 0; iTex < 8; iTex++)
@@ -3,6 +3,7 @@
 
 #include <Common/TString.h>
 #include <GL/glew.h>
+#include <vector>
 
 class CShader
 {
@@ -33,6 +34,8 @@ public:
     bool CompileVertexSource(const char* pkSource);
     bool CompilePixelSource(const char* pkSource);
     bool LinkShaders();
+    bool LoadProgramBinary(GLenum Format, const void* pkData, uint32 Size);
+    bool GetProgramBinary(GLenum& rOutFormat, std::vector<uint8>& rOutData);
     bool IsValidProgram();
     GLuint GetProgramID();
     GLuint GetUniformLocation(const char* pkUniform);
@@ -45,10 +48,12 @@ public:
     static CShader* FromResourceFile(const TString& rkShaderName);
     static CShader* CurrentShader();
     static void KillCachedShader();
+    static bool ProgramBinariesSupported();
 
     inline static int NumShaders() { return smNumShaders; }
 
 private:
+    void InitProgram();
     void CacheCommonUniforms();
     void DumpShaderSource(GLuint Shader, const TString& rkOut);
 };
@@ -145,7 +145,7 @@ CShaderGenerator::~CShaderGenerator()
 {
 }
 
-bool CShaderGenerator::CreateVertexShader(const CMaterial& rkMat)
+TString CShaderGenerator::GenerateVertexSource(const CMaterial& rkMat)
 {
     std::stringstream ShaderCode;
 
@@ -363,10 +363,10 @@ bool CShaderGenerator::CreateVertexShader(const CMaterial& rkMat)
 
 
     // Done!
-    return mpShader->CompileVertexSource(ShaderCode.str().c_str());
+    return TString(ShaderCode.str().c_str());
 }
 
-bool CShaderGenerator::CreatePixelShader(const CMaterial& rkMat)
+TString CShaderGenerator::GeneratePixelSource(const CMaterial& rkMat)
 {
     std::stringstream ShaderCode;
     ShaderCode << "#version 330 core\n"
@@ -497,17 +497,12 @@ bool CShaderGenerator::CreatePixelShader(const CMaterial& rkMat)
                << "}\n\n";
 
     // Done!
-    return mpShader->CompilePixelSource(ShaderCode.str().c_str());
+    return TString(ShaderCode.str().c_str());
 }
 
 CShader* CShaderGenerator::GenerateShader(const CMaterial& rkMat)
 {
-    CShaderGenerator Generator;
-    Generator.mpShader = new CShader();
-
-    bool Success = Generator.CreateVertexShader(rkMat);
-    if (Success) Success = Generator.CreatePixelShader(rkMat);
-
-    Generator.mpShader->LinkShaders();
-    return Generator.mpShader;
+    TString VertexSource = GenerateVertexSource(rkMat);
+    TString PixelSource = GeneratePixelSource(rkMat);
+    return new CShader(*VertexSource, *PixelSource);
 }
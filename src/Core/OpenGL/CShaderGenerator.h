@@ -22,14 +22,16 @@
  */
 class CShaderGenerator
 {
-    CShader *mpShader;
-
     CShaderGenerator();
     ~CShaderGenerator();
-    bool CreateVertexShader(const CMaterial& rkMat);
-    bool CreatePixelShader(const CMaterial& rkMat);
 
 public:
+    /** Version of the generated shader code. Bump this whenever the generated code changes, to invalidate cached shaders. */
+    static const uint32 skVersion = 1;
+
+    /** Source generation doesn't touch OpenGL, so it's safe to call without a context */
+    static TString GenerateVertexSource(const CMaterial& rkMat);
+    static TString GeneratePixelSource(const CMaterial& rkMat);
     static CShader* GenerateShader(const CMaterial& rkMat);
 };
 
@@ -0,0 +1,336 @@
+#include "NShaderCache.h"
+#include "CShaderGenerator.h"
+#include <Common/FileIO.h>
+#include <Common/FileUtil.h>
+#include <Common/Log.h>
+#include <Common/Macros.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace NShaderCache
+{
+
+/** Cache format version; bump this whenever the file layout changes */
+const uint32 gkCacheVersion = 2;
+
+/** Maximum size of the cache file. When the cache grows past this, the least recently used shaders are pruned on save. */
+const uint64 gkMaxCacheSize = 64 * 1024 * 1024;
+
+/** Path to the cache file */
+const char* gpkCachePath = "../resources/ShaderCache.bin";
+
+/** Cached data for a single material shader */
+struct SCachedShader
+{
+    TString VertexSource;
+    TString PixelSource;
+    GLenum BinaryFormat;
+    std::vector<uint8> BinaryData;
+    uint32 LastUsed; // Use counter value the last time the shader was needed; used to prune the cache
+};
+
+std::map<uint64, SCachedShader> gCachedShaders;
+TString gDriverID;
+uint32 gUseCounter = 0;
+bool gCacheLoaded = false;
+bool gDriverValidated = false;
+bool gCacheDirty = false;
+std::mutex gCacheMutex;
+
+/** Identifies the OpenGL driver. Program binaries are only valid on the driver that created them. */
+TString GetCurrentDriverID()
+{
+    TString Vendor = (const char*) glGetString(GL_VENDOR);
+    TString Renderer = (const char*) glGetString(GL_RENDERER);
+    TString Version = (const char*) glGetString(GL_VERSION);
+    return Vendor + "|" + Renderer + "|" + Version;
+}
+
+/** Marks a cached shader as the most recently used. Must be called with gCacheMutex locked.
+ *  This doesn't dirty the cache; recency alone isn't worth rewriting the file for, so it's
+ *  written out the next time the cache is saved because shaders were added or dropped.
+ */
+void MarkUsed(SCachedShader& rShader)
+{
+    rShader.LastUsed = ++gUseCounter;
+}
+
+/** Returns the number of bytes a cached shader takes up in the cache file */
+uint64 CachedShaderSize(const SCachedShader& kShader)
+{
+    // Hash, sized strings, binary format, and binary size
+    return 8 + (4 + kShader.VertexSource.Size()) + (4 + kShader.PixelSource.Size()) + 4 + 4 + kShader.BinaryData.size() + 4;
+}
+
+/** Drops the least recently used shaders until the cache fits within the size limit. Must be called with gCacheMutex locked. */
+void PruneCache()
+{
+    uint64 TotalSize = 0;
+    std::vector< std::pair<uint32, uint64> > UseOrder; // (last used, hash)
+    UseOrder.reserve(gCachedShaders.size());
+
+    for (auto Iter = gCachedShaders.begin(); Iter != gCachedShaders.end(); Iter++)
+    {
+        TotalSize += CachedShaderSize(Iter->second);
+        UseOrder.push_back( std::make_pair(Iter->second.LastUsed, Iter->first) );
+    }
+
+    if (TotalSize <= gkMaxCacheSize)
+        return;
+
+    std::sort(UseOrder.begin(), UseOrder.end());
+    uint32 NumPruned = 0;
+
+    for (uint32 OrderIdx = 0; OrderIdx < UseOrder.size() && TotalSize > gkMaxCacheSize; OrderIdx++)
+    {
+        auto Find = gCachedShaders.find(UseOrder[OrderIdx].second);
+        TotalSize -= CachedShaderSize(Find->second);
+        gCachedShaders.erase(Find);
+        NumPruned++;
+    }
+
+    debugf("Pruned %d least recently used shaders from shader cache", NumPruned);
+}
+
+/** Loads the cache file into memory. Must be called with gCacheMutex locked. */
+void ConditionalLoadCache()
+{
+    if (gCacheLoaded)
+        return;
+
+    gCacheLoaded = true;
+    CFileInStream File(gpkCachePath, EEndian::BigEndian);
+
+    // Magic, cache version, generator version
+    if (!File.IsValid() || File.Size() < 0xC)
+        return;
+
+    uint32 Magic = File.ReadLong();
+    uint32 CacheVersion = File.ReadLong();
+    uint32 GeneratorVersion = File.ReadLong();
+
+    if (Magic != FOURCC('SHDC') || CacheVersion != gkCacheVersion || GeneratorVersion != CShaderGenerator::skVersion)
+    {
+        debugf("Shader cache is out of date; discarding");
+        return;
+    }
+
+    // Every count and length is checked against the file size, so a truncated or corrupt cache
+    // can't have us allocating or reading based on garbage
+    const uint32 kFileSize = File.Size();
+    bool Valid = true;
+
+    auto HasBytes = [&](uint32 NumBytes) -> bool
+    {
+        Valid = Valid && (File.Tell() <= kFileSize) && (NumBytes <= kFileSize - File.Tell());
+        return Valid;
+    };
+
+    auto ReadCheckedString = [&]() -> TString
+    {
+        if (!HasBytes(4)) return "";
+        uint32 Length = File.ReadLong();
+        if (!HasBytes(Length)) return "";
+        return File.ReadString(Length);
+    };
+
+    gDriverID = ReadCheckedString();
+    uint32 NumShaders = (HasBytes(4) ? File.ReadLong() : 0);
+
+    // Smallest possible entry: hash, two empty sized strings, binary format, binary size, last used
+    const uint32 kMinShaderSize = 8 + 4 + 4 + 4 + 4 + 4;
+
+    if (Valid && NumShaders > (kFileSize - File.Tell()) / kMinShaderSize)
+        Valid = false;
+
+    for (uint32 ShaderIdx = 0; Valid && ShaderIdx < NumShaders; ShaderIdx++)
+    {
+        if (!HasBytes(8)) break;
+        uint64 Hash = File.ReadLongLong();
+        SCachedShader& rShader = gCachedShaders[Hash];
+        rShader.VertexSource = ReadCheckedString();
+        rShader.PixelSource = ReadCheckedString();
+
+        if (!HasBytes(8)) break;
+        rShader.BinaryFormat = File.ReadLong();
+        uint32 BinarySize = File.ReadLong();
+
+        if (!HasBytes(BinarySize)) break;
+        rShader.BinaryData.resize(BinarySize);
+        File.ReadBytes(rShader.BinaryData.data(), rShader.BinaryData.size());
+
+        if (!HasBytes(4)) break;
+        rShader.LastUsed = File.ReadLong();
+        gUseCounter = std::max(gUseCounter, rShader.LastUsed);
+    }
+
+    if (!Valid)
+    {
+        warnf("Shader cache is corrupt; discarding");
+        gCachedShaders.clear();
+        gDriverID = "";
+        gUseCounter = 0;
+        return;
+    }
+
+    debugf("Loaded %d shaders from shader cache", NumShaders);
+}
+
+/** Discards cached program binaries if they were created by a different driver. Must be called with
+ *  gCacheMutex locked and an OpenGL context current.
+ */
+void ConditionalValidateDriver()
+{
+    if (gDriverValidated)
+        return;
+
+    gDriverValidated = true;
+    TString DriverID = GetCurrentDriverID();
+
+    if (DriverID != gDriverID)
+    {
+        if (!gDriverID.IsEmpty())
+            debugf("OpenGL driver has changed; discarding cached shader binaries");
+
+        for (auto Iter = gCachedShaders.begin(); Iter != gCachedShaders.end(); Iter++)
+            std::vector<uint8>().swap(Iter->second.BinaryData);
+
+        gDriverID = DriverID;
+        gCacheDirty = true;
+    }
+}
+
+CShader* LoadShader(uint64 MaterialHash)
+{
+    std::lock_guard<std::mutex> Lock(gCacheMutex);
+    ConditionalLoadCache();
+    ConditionalValidateDriver();
+
+    auto Find = gCachedShaders.find(MaterialHash);
+
+    if (Find == gCachedShaders.end())
+        return nullptr;
+
+    SCachedShader& rShader = Find->second;
+    MarkUsed(rShader);
+
+    // Use the program binary if we have one, to skip compilation entirely
+    if (!rShader.BinaryData.empty())
+    {
+        CShader* pShader = new CShader();
+
+        if (pShader->LoadProgramBinary(rShader.BinaryFormat, rShader.BinaryData.data(), rShader.BinaryData.size()))
+            return pShader;
+
+        delete pShader;
+        std::vector<uint8>().swap(rShader.BinaryData);
+        gCacheDirty = true;
+    }
+
+    // Fall back to compiling the cached source, and retrieve a fresh binary while we're at it
+    CShader* pShader = new CShader(*rShader.VertexSource, *rShader.PixelSource);
+
+    if (!pShader->IsValidProgram())
+    {
+        delete pShader;
+        gCachedShaders.erase(Find);
+        gCacheDirty = true;
+        return nullptr;
+    }
+
+    if (pShader->GetProgramBinary(rShader.BinaryFormat, rShader.BinaryData))
+        gCacheDirty = true;
+
+    return pShader;
+}
+
+bool FindShaderSource(uint64 MaterialHash, TString& rOutVertexSource, TString& rOutPixelSource)
+{
+    std::lock_guard<std::mutex> Lock(gCacheMutex);
+    ConditionalLoadCache();
+
+    auto Find = gCachedShaders.find(MaterialHash);
+
+    if (Find == gCachedShaders.end())
+        return false;
+
+    MarkUsed(Find->second);
+    rOutVertexSource = Find->second.VertexSource;
+    rOutPixelSource = Find->second.PixelSource;
+    return true;
+}
+
+void StoreShader(uint64 MaterialHash, const TString& kVertexSource, const TString& kPixelSource, CShader* pShader)
+{
+    ASSERT(pShader && pShader->IsValidProgram());
+
+    std::lock_guard<std::mutex> Lock(gCacheMutex);
+    ConditionalLoadCache();
+    ConditionalValidateDriver();
+
+    SCachedShader& rShader = gCachedShaders[MaterialHash];
+    rShader.VertexSource = kVertexSource;
+    rShader.PixelSource = kPixelSource;
+    MarkUsed(rShader);
+
+    if (!pShader->GetProgramBinary(rShader.BinaryFormat, rShader.BinaryData))
+    {
+        rShader.BinaryFormat = 0;
+        rShader.BinaryData.clear();
+    }
+
+    gCacheDirty = true;
+}
+
+void SaveCache()
+{
+    std::lock_guard<std::mutex> Lock(gCacheMutex);
+
+    if (!gCacheDirty)
+        return;
+
+    PruneCache();
+
+    // Write to a temp file first, so an interrupted save can't leave a truncated cache behind
+    const TString kNewCachePath = TString(gpkCachePath) + ".tmp";
+    {
+        CFileOutStream File(kNewCachePath, EEndian::BigEndian);
+
+        if (!File.IsValid())
+        {
+            warnf("Failed to open shader cache for writing: %s", *kNewCachePath);
+            return;
+        }
+
+        debugf("Saving shader cache: %s", gpkCachePath);
+        File.WriteLong(FOURCC('SHDC'));
+        File.WriteLong(gkCacheVersion);
+        File.WriteLong(CShaderGenerator::skVersion);
+        File.WriteSizedString(gDriverID);
+        File.WriteLong(gCachedShaders.size());
+
+        for (auto Iter = gCachedShaders.begin(); Iter != gCachedShaders.end(); Iter++)
+        {
+            const SCachedShader& kShader = Iter->second;
+            File.WriteLongLong(Iter->first);
+            File.WriteSizedString(kShader.VertexSource);
+            File.WriteSizedString(kShader.PixelSource);
+            File.WriteLong(kShader.BinaryFormat);
+            File.WriteLong(kShader.BinaryData.size());
+            File.WriteBytes(kShader.BinaryData.data(), kShader.BinaryData.size());
+            File.WriteLong(kShader.LastUsed);
+        }
+    }
+
+    FileUtil::DeleteFile(gpkCachePath);
+
+    if (!FileUtil::MoveFile(kNewCachePath, gpkCachePath))
+        warnf("Failed to replace shader cache: %s", gpkCachePath);
+
+    gCacheDirty = false;
+}
+
+}
@@ -0,0 +1,33 @@
+#ifndef NSHADERCACHE_H
+#define NSHADERCACHE_H
+
+#include "CShader.h"
+#include <Common/BasicTypes.h>
+#include <Common/TString.h>
+
+/** NShaderCache: Persistent cache of generated material shaders, keyed by material parameter hash.
+ *  Generated GLSL sources are stored along with linked program binaries, if the driver supports
+ *  GL_ARB_get_program_binary. Sources stay valid as long as the shader generator version matches;
+ *  binaries are discarded if the OpenGL driver changes. The cache is capped in size; once it grows
+ *  past the cap, the least recently used shaders are dropped when it's saved.
+ */
+namespace NShaderCache
+{
+
+/** Create a shader for the given material hash from the cache. Returns null if the material isn't cached.
+ *  Requires a current OpenGL context.
+ */
+CShader* LoadShader(uint64 MaterialHash);
+
+/** Retrieve the cached shader sources for a material hash. Doesn't require an OpenGL context. */
+bool FindShaderSource(uint64 MaterialHash, TString& rOutVertexSource, TString& rOutPixelSource);
+
+/** Add a newly generated shader to the cache. The program binary is retrieved from pShader, if possible. */
+void StoreShader(uint64 MaterialHash, const TString& kVertexSource, const TString& kPixelSource, CShader* pShader);
+
+/** Write the cache out to disk, if it has been modified */
+void SaveCache();
+
+}
+
+#endif // NSHADERCACHE_H
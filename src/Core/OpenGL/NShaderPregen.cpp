@@ -0,0 +1,165 @@
+#include "NShaderPregen.h"
+#include "CShaderGenerator.h"
+#include "NShaderCache.h"
+#include "Core/CWorkerPool.h"
+#include "Core/Render/CGraphics.h"
+#include "Core/Resource/CMaterial.h"
+#include <Common/CTimer.h>
+#include <Common/Log.h>
+
+#include <map>
+#include <mutex>
+#include <set>
+
+namespace NShaderPregen
+{
+
+/** Shader waiting to be compiled. Sources are left empty if the shader cache already has this shader. */
+struct SQueuedShader
+{
+    TString VertexSource;
+    TString PixelSource;
+};
+
+std::map<uint64, SQueuedShader> gQueuedShaders;
+std::map<uint64, CShader*> gCompiledShaders;
+std::mutex gQueueMutex;
+
+void QueueMaterials(const std::vector<CMaterial*>& kMaterials)
+{
+    // Without an OpenGL context (such as when cooking headlessly) nothing will ever compile the queued shaders.
+    // Materials also can't be hashed off the main thread, which happens when areas are loaded to be recooked;
+    // those areas aren't being drawn, so there's nothing to pregenerate for anyway.
+    if (!CGraphics::IsInitialized() || !CGraphics::IsMainThread())
+        return;
+
+    // Gather unique materials that don't have a shader yet. Hashing isn't thread-safe, so do it up front.
+    std::vector<CMaterial*> Materials;
+    std::vector<uint64> Hashes;
+    std::set<uint64> UsedHashes;
+
+    {
+        std::lock_guard<std::mutex> Lock(gQueueMutex);
+
+        for (uint32 MatIdx = 0; MatIdx < kMaterials.size(); MatIdx++)
+        {
+            CMaterial* pMat = kMaterials[MatIdx];
+            uint64 Hash = pMat->HashParameters();
+
+            if (CMaterial::IsShaderLoaded(Hash) ||
+                gQueuedShaders.find(Hash) != gQueuedShaders.end() ||
+                gCompiledShaders.find(Hash) != gCompiledShaders.end() ||
+                !UsedHashes.insert(Hash).second)
+            {
+                continue;
+            }
+
+            Materials.push_back(pMat);
+            Hashes.push_back(Hash);
+        }
+    }
+
+    if (Materials.empty())
+        return;
+
+    // Generate sources in parallel
+    std::vector<SQueuedShader> Shaders(Materials.size());
+
+    CWorkerPool::Shared()->ParallelFor(Materials.size(), [&](uint32 MatIdx)
+    {
+        TString CachedVertexSource, CachedPixelSource;
+
+        if (!NShaderCache::FindShaderSource(Hashes[MatIdx], CachedVertexSource, CachedPixelSource))
+        {
+            Shaders[MatIdx].VertexSource = CShaderGenerator::GenerateVertexSource(*Materials[MatIdx]);
+            Shaders[MatIdx].PixelSource = CShaderGenerator::GeneratePixelSource(*Materials[MatIdx]);
+        }
+    });
+
+    std::lock_guard<std::mutex> Lock(gQueueMutex);
+
+    for (uint32 MatIdx = 0; MatIdx < Materials.size(); MatIdx++)
+        gQueuedShaders[Hashes[MatIdx]] = std::move(Shaders[MatIdx]);
+
+    debugf("Queued %d shaders for background compilation", Materials.size());
+}
+
+void CompileQueuedShaders(double TimeBudget /*= gkDefaultCompileBudget*/)
+{
+    double StartTime = CTimer::GlobalTime();
+
+    while (true)
+    {
+        uint64 Hash;
+        SQueuedShader Queued;
+
+        {
+            std::lock_guard<std::mutex> Lock(gQueueMutex);
+            if (gQueuedShaders.empty()) return;
+
+            auto Iter = gQueuedShaders.begin();
+            Hash = Iter->first;
+            Queued = std::move(Iter->second);
+            gQueuedShaders.erase(Iter);
+        }
+
+        // Prefer the shader cache, since it can skip compilation entirely
+        CShader* pShader = NShaderCache::LoadShader(Hash);
+
+        if (!pShader && !Queued.VertexSource.IsEmpty())
+        {
+            pShader = new CShader(*Queued.VertexSource, *Queued.PixelSource);
+
+            if (pShader->IsValidProgram())
+                NShaderCache::StoreShader(Hash, Queued.VertexSource, Queued.PixelSource, pShader);
+        }
+
+        // Shaders that failed to compile are dropped; the material will report the failure when it's drawn
+        if (pShader && !pShader->IsValidProgram())
+        {
+            delete pShader;
+            pShader = nullptr;
+        }
+
+        if (pShader)
+        {
+            std::lock_guard<std::mutex> Lock(gQueueMutex);
+            gCompiledShaders[Hash] = pShader;
+        }
+
+        if (CTimer::GlobalTime() - StartTime >= TimeBudget)
+            return;
+    }
+}
+
+bool IsShaderQueued(uint64 MaterialHash)
+{
+    std::lock_guard<std::mutex> Lock(gQueueMutex);
+    return gQueuedShaders.find(MaterialHash) != gQueuedShaders.end();
+}
+
+CShader* TakeShader(uint64 MaterialHash)
+{
+    std::lock_guard<std::mutex> Lock(gQueueMutex);
+    auto Find = gCompiledShaders.find(MaterialHash);
+
+    if (Find == gCompiledShaders.end())
+        return nullptr;
+
+    CShader* pShader = Find->second;
+    gCompiledShaders.erase(Find);
+    return pShader;
+}
+
+void Clear()
+{
+    std::lock_guard<std::mutex> Lock(gQueueMutex);
+    gQueuedShaders.clear();
+
+    for (auto Iter = gCompiledShaders.begin(); Iter != gCompiledShaders.end(); Iter++)
+        delete Iter->second;
+
+    gCompiledShaders.clear();
+}
+
+}
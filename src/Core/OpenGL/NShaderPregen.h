@@ -0,0 +1,42 @@
+#ifndef NSHADERPREGEN_H
+#define NSHADERPREGEN_H
+
+#include "CShader.h"
+#include <Common/BasicTypes.h>
+#include <vector>
+
+class CMaterial;
+
+/** NShaderPregen: Background shader generation for newly loaded materials.
+ *  GLSL sources are generated on the worker pool as soon as materials are loaded. The queued
+ *  shaders are then compiled on the OpenGL context thread a few at a time each frame, so that
+ *  a newly loaded area doesn't stall the first time it's drawn. Materials whose shader is still
+ *  queued are skipped while drawing until their shader is ready.
+ */
+namespace NShaderPregen
+{
+
+/** Default per-frame time budget for compiling queued shaders, in seconds */
+const double gkDefaultCompileBudget = 0.004;
+
+/** Generate shader sources for the given materials on the worker pool and queue them for compilation.
+ *  Blocks until source generation is finished, so the materials only need to stay alive for the call.
+ *  Does nothing if graphics haven't been initialized, since there's no context to compile them on.
+ */
+void QueueMaterials(const std::vector<CMaterial*>& kMaterials);
+
+/** Compile queued shaders until the time budget (in seconds) runs out. Requires a current OpenGL context. */
+void CompileQueuedShaders(double TimeBudget = gkDefaultCompileBudget);
+
+/** Returns whether the shader for the given material hash is queued but hasn't been compiled yet */
+bool IsShaderQueued(uint64 MaterialHash);
+
+/** Take ownership of a compiled shader for the given material hash. Returns null if there isn't one. */
+CShader* TakeShader(uint64 MaterialHash);
+
+/** Clear the queue and delete any compiled shaders that were never taken. Requires a current OpenGL context. */
+void Clear();
+
+}
+
+#endif // NSHADERPREGEN_H
@@ -1,5 +1,7 @@
 #include "CGraphics.h"
 #include "Core/OpenGL/CShader.h"
+#include "Core/OpenGL/NShaderCache.h"
+#include "Core/OpenGL/NShaderPregen.h"
 #include "Core/Resource/CMaterial.h"
 #include <Common/Log.h>
 
@@ -12,6 +14,7 @@ CUniformBuffer* CGraphics::mpBoneTransformBuffer;
 uint32 CGraphics::mContextIndices = 0;
 uint32 CGraphics::mActiveContext = -1;
 bool CGraphics::mInitialized = false;
+std::thread::id CGraphics::mMainThreadID;
 std::vector<CVertexArrayManager*> CGraphics::mVAMs;
 bool CGraphics::mIdentityBoneTransforms = false;
 
@@ -52,6 +55,8 @@ void CGraphics::Initialize()
         sNumLights = 0;
         sWorldLightMultiplier = 1.f;
 
+        // Graphics are always initialized from the thread that owns the OpenGL context
+        mMainThreadID = std::this_thread::get_id();
         mInitialized = true;
     }
     mpMVPBlockBuffer->BindBase(0);
@@ -72,6 +77,8 @@ void CGraphics::Shutdown()
         delete mpPixelBlockBuffer;
         delete mpLightBlockBuffer;
         delete mpBoneTransformBuffer;
+        NShaderPregen::Clear();
+        NShaderCache::SaveCache();
         mInitialized = false;
     }
 }
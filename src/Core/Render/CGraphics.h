@@ -10,6 +10,7 @@
 #include <Common/Math/CVector3f.h>
 #include <Common/Math/CVector4f.h>
 #include <GL/glew.h>
+#include <thread>
 
 /**
  * todo: this entire thing needs to be further abstracted, other classes shouldn't
@@ -28,6 +29,7 @@ class CGraphics
     static uint32 mContextIndices;
     static uint32 mActiveContext;
     static bool mInitialized;
+    static std::thread::id mMainThreadID;
     static std::vector<CVertexArrayManager*> mVAMs;
     static bool mIdentityBoneTransforms;
 
@@ -90,6 +92,8 @@ public:
     // Functions
     static void Initialize();
     static void Shutdown();
+    static inline bool IsInitialized() { return mInitialized; }
+    static inline bool IsMainThread()  { return std::this_thread::get_id() == mMainThreadID; }
     static void UpdateMVPBlock();
     static void UpdateVertexBlock();
     static void UpdatePixelBlock();
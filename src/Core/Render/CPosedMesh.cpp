@@ -0,0 +1,223 @@
+#include "CPosedMesh.h"
+#include <Common/Math/MathUtil.h>
+#include <cfloat>
+
+CPosedMesh::CPosedMesh()
+    : mpModel(nullptr)
+    , mPosedAABox(CAABox::skZero)
+{
+}
+
+void CPosedMesh::SetModel(CModel *pModel)
+{
+    if (mpModel == pModel)
+        return;
+
+    mpModel = pModel;
+    mBindPositions.clear();
+    mPrimitives.clear();
+    mPosedPositions.clear();
+    mPosedAABox = (pModel ? pModel->AABox() : CAABox::skZero);
+
+    for (uint32 iWgt = 0; iWgt < 4; iWgt++)
+    {
+        mBoneIndices[iWgt].clear();
+        mBoneWeights[iWgt].clear();
+    }
+
+    if (!pModel)
+        return;
+
+    // Flatten the model's primitives and look up the skin weights for each vertex up front,
+    // since looking up weights in the skin is too slow to do every time the mesh is posed.
+    CSkin *pSkin = pModel->Skin();
+
+    for (uint32 iSurf = 0; iSurf < pModel->GetSurfaceCount(); iSurf++)
+    {
+        SSurface *pSurf = pModel->GetSurface(iSurf);
+
+        for (uint32 iPrim = 0; iPrim < pSurf->Primitives.size(); iPrim++)
+        {
+            const SSurface::SPrimitive& rkPrim = pSurf->Primitives[iPrim];
+
+            SPrimitive Prim;
+            Prim.Type = rkPrim.Type;
+            Prim.FirstVertex = mBindPositions.size();
+            Prim.NumVertices = rkPrim.Vertices.size();
+            mPrimitives.push_back(Prim);
+
+            for (uint32 iVtx = 0; iVtx < rkPrim.Vertices.size(); iVtx++)
+            {
+                const CVertex& rkVtx = rkPrim.Vertices[iVtx];
+                mBindPositions.push_back(rkVtx.Position);
+
+                for (uint32 iWgt = 0; iWgt < 4; iWgt++)
+                {
+                    if (pSkin)
+                    {
+                        const SVertexWeights& rkWeights = pSkin->WeightsForVertex(rkVtx.ArrayPosition);
+                        mBoneIndices[iWgt].push_back(rkWeights.Indices[iWgt]);
+                        mBoneWeights[iWgt].push_back(rkWeights.Weights[iWgt]);
+                    }
+                    else
+                    {
+                        mBoneIndices[iWgt].push_back(0);
+                        mBoneWeights[iWgt].push_back(0.f);
+                    }
+                }
+            }
+        }
+    }
+
+    mPosedPositions = mBindPositions;
+}
+
+void CPosedMesh::Pose(const CBoneTransformData& rkData)
+{
+    if (!mpModel)
+        return;
+
+    // Unskinned models don't move with the skeleton
+    if (!mpModel->IsSkinned())
+    {
+        mPosedPositions = mBindPositions;
+        mPosedAABox = mpModel->AABox();
+        return;
+    }
+
+    const uint8* kIndices[4] = { mBoneIndices[0].data(), mBoneIndices[1].data(), mBoneIndices[2].data(), mBoneIndices[3].data() };
+    const float* kWeights[4] = { mBoneWeights[0].data(), mBoneWeights[1].data(), mBoneWeights[2].data(), mBoneWeights[3].data() };
+    SkinPositions(mBindPositions.data(), kIndices, kWeights, mBindPositions.size(), rkData, mPosedPositions.data(), mPosedAABox);
+}
+
+std::pair<bool,float> CPosedMesh::IntersectsRay(const CRay& rkRay, bool AllowBackfaces /*= false*/) const
+{
+    bool Hit = false;
+    float HitDist = 0.f;
+
+    if (!mPosedAABox.IntersectsRay(rkRay).first)
+        return std::pair<bool,float>(false, 0.f);
+
+    for (uint32 iPrim = 0; iPrim < mPrimitives.size(); iPrim++)
+    {
+        const SPrimitive& rkPrim = mPrimitives[iPrim];
+        const CVector3f *pkVerts = &mPosedPositions[rkPrim.FirstVertex];
+        uint32 NumTris;
+
+        if (rkPrim.Type == EPrimitiveType::Triangles)
+            NumTris = rkPrim.NumVertices / 3;
+        else if (rkPrim.Type == EPrimitiveType::TriangleFan || rkPrim.Type == EPrimitiveType::TriangleStrip)
+            NumTris = (rkPrim.NumVertices >= 3 ? rkPrim.NumVertices - 2 : 0);
+        else
+            continue;
+
+        for (uint32 iTri = 0; iTri < NumTris; iTri++)
+        {
+            uint32 IdxA, IdxB, IdxC;
+
+            if (rkPrim.Type == EPrimitiveType::Triangles)
+            {
+                IdxA = iTri * 3;
+                IdxB = IdxA + 1;
+                IdxC = IdxA + 2;
+            }
+
+            else if (rkPrim.Type == EPrimitiveType::TriangleFan)
+            {
+                IdxA = 0;
+                IdxB = iTri + 1;
+                IdxC = iTri + 2;
+            }
+
+            else
+            {
+                // Flip every other triangle in a strip to keep the winding order consistent
+                IdxA = (iTri & 0x1 ? iTri + 2 : iTri);
+                IdxB = iTri + 1;
+                IdxC = (iTri & 0x1 ? iTri : iTri + 2);
+            }
+
+            std::pair<bool,float> TriResult = Math::RayTriangleIntersection(rkRay, pkVerts[IdxA], pkVerts[IdxB], pkVerts[IdxC], AllowBackfaces);
+
+            if (TriResult.first && (!Hit || TriResult.second < HitDist))
+            {
+                Hit = true;
+                HitDist = TriResult.second;
+            }
+        }
+    }
+
+    return std::pair<bool,float>(Hit, HitDist);
+}
+
+void CPosedMesh::SkinPositions(const CVector3f *pkBindPositions, const uint8* const pkIndices[4], const float* const pkWeights[4],
+                               uint32 NumVertices, const CBoneTransformData& rkData, CVector3f *pOutPositions, CAABox& rOutAABox)
+{
+    // Build a matrix palette covering every possible bone index. Bone 0 and any bones that aren't
+    // tracked by the transform data are left zeroed, so they drop out of the weighted sum without
+    // needing a branch per weight. This matches the vertex shader, which skips bone 0.
+    struct SPaletteMatrix { float M[12]; };
+    static thread_local SPaletteMatrix sPalette[256];
+
+    uint32 NumBones = Math::Min<uint32>(rkData.NumTrackedBones(), 256);
+
+    for (uint32 iBone = 0; iBone < 256; iBone++)
+    {
+        float *pM = sPalette[iBone].M;
+
+        if (iBone == 0 || iBone >= NumBones)
+        {
+            for (uint32 iElem = 0; iElem < 12; iElem++)
+                pM[iElem] = 0.f;
+        }
+        else
+        {
+            const CTransform4f& rkMtx = rkData[iBone];
+
+            for (uint32 iRow = 0; iRow < 3; iRow++)
+                for (uint32 iCol = 0; iCol < 4; iCol++)
+                    pM[iRow * 4 + iCol] = rkMtx[iRow][iCol];
+        }
+    }
+
+    // Skin vertices. Each bone influence is accumulated as a pre-weighted 3x4 matrix, which is then
+    // applied to the vertex once; the loop body is straight-line code the compiler can vectorize.
+    CVector3f Min( FLT_MAX,  FLT_MAX,  FLT_MAX);
+    CVector3f Max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+    for (uint32 iVtx = 0; iVtx < NumVertices; iVtx++)
+    {
+        float Blend[12];
+        const float *pkM0 = sPalette[ pkIndices[0][iVtx] ].M;
+        float W0 = pkWeights[0][iVtx];
+
+        for (uint32 iElem = 0; iElem < 12; iElem++)
+            Blend[iElem] = pkM0[iElem] * W0;
+
+        for (uint32 iWgt = 1; iWgt < 4; iWgt++)
+        {
+            const float *pkM = sPalette[ pkIndices[iWgt][iVtx] ].M;
+            float W = pkWeights[iWgt][iVtx];
+
+            for (uint32 iElem = 0; iElem < 12; iElem++)
+                Blend[iElem] += pkM[iElem] * W;
+        }
+
+        const CVector3f& rkPos = pkBindPositions[iVtx];
+        CVector3f Out(
+            Blend[0] * rkPos.X + Blend[1] * rkPos.Y + Blend[2]  * rkPos.Z + Blend[3],
+            Blend[4] * rkPos.X + Blend[5] * rkPos.Y + Blend[6]  * rkPos.Z + Blend[7],
+            Blend[8] * rkPos.X + Blend[9] * rkPos.Y + Blend[10] * rkPos.Z + Blend[11]
+        );
+        pOutPositions[iVtx] = Out;
+
+        Min.X = Math::Min(Min.X, Out.X);
+        Min.Y = Math::Min(Min.Y, Out.Y);
+        Min.Z = Math::Min(Min.Z, Out.Z);
+        Max.X = Math::Max(Max.X, Out.X);
+        Max.Y = Math::Max(Max.Y, Out.Y);
+        Max.Z = Math::Max(Max.Z, Out.Z);
+    }
+
+    rOutAABox = (NumVertices > 0 ? CAABox(Min, Max) : CAABox::skZero);
+}
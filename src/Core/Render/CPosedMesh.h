@@ -0,0 +1,52 @@
+#ifndef CPOSEDMESH_H
+#define CPOSEDMESH_H
+
+#include "CBoneTransformData.h"
+#include "Core/Resource/Model/CModel.h"
+#include <Common/BasicTypes.h>
+#include <Common/Math/CAABox.h>
+#include <Common/Math/CRay.h>
+#include <Common/Math/CVector3f.h>
+#include <vector>
+
+/** CPosedMesh: Skins the vertex positions of a model on the CPU.
+ *  The GPU only ever sees the skinned mesh when it's drawn, so this is used for anything on the
+ *  CPU that needs to know where an animated model actually is, such as ray picking and culling.
+ *  Skinning matches the vertex shader: bone index 0 doesn't contribute to the final position.
+ */
+class CPosedMesh
+{
+    struct SPrimitive
+    {
+        EPrimitiveType Type;
+        uint32 FirstVertex;
+        uint32 NumVertices;
+    };
+
+    // Bind pose data, flattened from the model's surfaces.
+    // Bone weights are stored in separate streams so the skinning loop has no branches.
+    CModel *mpModel;
+    std::vector<CVector3f> mBindPositions;
+    std::vector<uint8> mBoneIndices[4];
+    std::vector<float> mBoneWeights[4];
+    std::vector<SPrimitive> mPrimitives;
+
+    // Posed data
+    std::vector<CVector3f> mPosedPositions;
+    CAABox mPosedAABox;
+
+public:
+    CPosedMesh();
+    void SetModel(CModel *pModel);
+    void Pose(const CBoneTransformData& rkData);
+    std::pair<bool,float> IntersectsRay(const CRay& rkRay, bool AllowBackfaces = false) const;
+
+    static void SkinPositions(const CVector3f *pkBindPositions, const uint8* const pkIndices[4], const float* const pkWeights[4],
+                              uint32 NumVertices, const CBoneTransformData& rkData, CVector3f *pOutPositions, CAABox& rOutAABox);
+
+    inline CModel* Model() const                { return mpModel; }
+    inline const CAABox& AABox() const          { return mPosedAABox; }
+    inline uint32 NumVertices() const           { return mBindPositions.size(); }
+};
+
+#endif // CPOSEDMESH_H
@@ -3,6 +3,7 @@
 #include "CDrawUtil.h"
 #include "CGraphics.h"
 #include "Core/GameProject/CResourceStore.h"
+#include "Core/OpenGL/NShaderPregen.h"
 #include "Core/Resource/Factory/CTextureDecoder.h"
 #include <Common/Math/CTransform4f.h>
 
@@ -319,6 +320,9 @@ void CRenderer::BeginFrame()
     CGraphics::SetActiveContext(mContextIndex);
     glGetIntegerv(GL_FRAMEBUFFER_BINDING, &mDefaultFramebuffer);
 
+    // Compile some of the shaders that were queued when resources were loaded
+    NShaderPregen::CompileQueuedShaders();
+
     mSceneFramebuffer.SetMultisamplingEnabled(true);
     mSceneFramebuffer.Resize(mViewportWidth, mViewportHeight);
     mSceneFramebuffer.Bind();
@@ -1,12 +1,22 @@
 #include "CAnimation.h"
 #include <Common/Math/CTransform4f.h>
 #include <Common/Math/MathUtil.h>
+#include <mutex>
+
+// Animations with decompressed keys, most recently evaluated first
+static std::list<const CAnimation*> gResidentAnims;
+static uint32 gResidentKeyBytes = 0;
+static uint32 gDecompressedKeyBudget = 16 * 1024 * 1024;
+static std::mutex gResidentMutex;
+
+static const float gkSqrt2 = 1.41421356f;
 
 CAnimation::CAnimation(CResourceEntry *pEntry /*= 0*/)
     : CResource(pEntry)
     , mDuration(0.f)
     , mTickInterval(0.0333333f)
     , mNumKeys(0)
+    , mKeysResident(false)
 {
     for (uint32 iBone = 0; iBone < 100; iBone++)
     {
@@ -16,6 +26,12 @@ CAnimation::CAnimation(CResourceEntry *pEntry /*= 0*/)
     }
 }
 
+CAnimation::~CAnimation()
+{
+    std::lock_guard<std::mutex> Lock(gResidentMutex);
+    ReleaseDecompressedKeys();
+}
+
 CDependencyTree* CAnimation::BuildDependencyTree() const
 {
     CDependencyTree *pTree = new CDependencyTree();
@@ -23,17 +39,31 @@ CDependencyTree* CAnimation::BuildDependencyTree() const
     return pTree;
 }
 
+/** Find the key to sample from at the given time, and the interpolation factor to the next key. Returns false if there are no keys. */
+bool CAnimation::FindKeyInterpolation(float Time, uint32& rOutLowKey, float& rOutT) const
+{
+    if (mDuration == 0.f) return false;
+
+    if (Time >= mDuration) Time = mDuration;
+    if (Time >= FLT_EPSILON) Time -= FLT_EPSILON;
+    rOutT = fmodf(Time, mTickInterval) / mTickInterval;
+    rOutLowKey = (uint32) (Time / mTickInterval);
+    if (rOutLowKey == (mNumKeys - 1)) rOutLowKey = mNumKeys - 2;
+    return true;
+}
+
 void CAnimation::EvaluateTransform(float Time, uint32 BoneID, CVector3f *pOutTranslation, CQuaternion *pOutRotation, CVector3f *pOutScale) const
 {
     const bool kInterpolate = true;
     if (!pOutTranslation && !pOutRotation && !pOutScale) return;
-    if (mDuration == 0.f) return;
 
-    if (Time >= mDuration) Time = mDuration;
-    if (Time >= FLT_EPSILON) Time -= FLT_EPSILON;
-    float t = fmodf(Time, mTickInterval) / mTickInterval;
-    uint32 LowKey = (uint32) (Time / mTickInterval);
-    if (LowKey == (mNumKeys - 1)) LowKey = mNumKeys - 2;
+    uint32 LowKey;
+    float t;
+    if (!FindKeyInterpolation(Time, LowKey, t)) return;
+
+    // Hold the lock while sampling so another thread can't evict our keys out from under us
+    std::lock_guard<std::mutex> Lock(gResidentMutex);
+    ConditionalDecompressKeys();
 
     uint8 ScaleChannel = mBoneInfo[BoneID].ScaleChannelIdx;
     uint8 RotChannel = mBoneInfo[BoneID].RotationChannelIdx;
@@ -61,7 +91,271 @@ void CAnimation::EvaluateTransform(float Time, uint32 BoneID, CVector3f *pOutTra
     }
 }
 
+/** Evaluate the transforms of a list of bones at once. Outputs are indexed the same as rkBoneIDs,
+ *  and are only written for bones that have a channel of that type.
+ */
+void CAnimation::EvaluatePose(float Time, const std::vector<uint32>& rkBoneIDs, CVector3f *pOutTranslations, CQuaternion *pOutRotations, CVector3f *pOutScales) const
+{
+    uint32 LowKey;
+    float t;
+    if (!FindKeyInterpolation(Time, LowKey, t)) return;
+
+    // Hold the lock while sampling so another thread can't evict our keys out from under us
+    std::lock_guard<std::mutex> Lock(gResidentMutex);
+    ConditionalDecompressKeys();
+
+    for (uint32 iBone = 0; iBone < rkBoneIDs.size(); iBone++)
+    {
+        const SBoneChannelInfo& rkInfo = mBoneInfo[ rkBoneIDs[iBone] ];
+
+        if (rkInfo.ScaleChannelIdx != 0xFF)
+        {
+            const CVector3f *pkKeys = &mScaleChannels[rkInfo.ScaleChannelIdx][LowKey];
+            pOutScales[iBone] = Math::Lerp<CVector3f>(pkKeys[0], pkKeys[1], t);
+        }
+
+        if (rkInfo.RotationChannelIdx != 0xFF)
+        {
+            const CQuaternion *pkKeys = &mRotationChannels[rkInfo.RotationChannelIdx][LowKey];
+            pOutRotations[iBone] = pkKeys[0].Slerp(pkKeys[1], t);
+        }
+
+        if (rkInfo.TranslationChannelIdx != 0xFF)
+        {
+            const CVector3f *pkKeys = &mTranslationChannels[rkInfo.TranslationChannelIdx][LowKey];
+            pOutTranslations[iBone] = Math::Lerp<CVector3f>(pkKeys[0], pkKeys[1], t);
+        }
+    }
+}
+
 bool CAnimation::HasTranslation(uint32 BoneID) const
 {
     return (mBoneInfo[BoneID].TranslationChannelIdx != 0xFF);
 }
+
+/** Set the amount of memory that decompressed animation keys may use before least recently used animations are evicted */
+void CAnimation::SetDecompressedKeyBudget(uint32 Bytes)
+{
+    std::lock_guard<std::mutex> Lock(gResidentMutex);
+    gDecompressedKeyBudget = Bytes;
+
+    while (gResidentKeyBytes > gDecompressedKeyBudget && !gResidentAnims.empty())
+        gResidentAnims.back()->ReleaseDecompressedKeys();
+}
+
+/** Returns the amount of memory currently used by decompressed animation keys */
+uint32 CAnimation::DecompressedKeyMemory()
+{
+    std::lock_guard<std::mutex> Lock(gResidentMutex);
+    return gResidentKeyBytes;
+}
+
+// ************ PRIVATE ************
+/** Compress the loaded keys and release the full precision data. Called by the loader once all keys are read. */
+void CAnimation::CompressKeys()
+{
+    mCompressedScaleChannels.resize(mScaleChannels.size());
+    mCompressedRotationChannels.resize(mRotationChannels.size());
+    mCompressedTranslationChannels.resize(mTranslationChannels.size());
+
+    for (uint32 iChan = 0; iChan < mScaleChannels.size(); iChan++)
+        CompressVectorChannel(mScaleChannels[iChan], mCompressedScaleChannels[iChan]);
+
+    for (uint32 iChan = 0; iChan < mTranslationChannels.size(); iChan++)
+        CompressVectorChannel(mTranslationChannels[iChan], mCompressedTranslationChannels[iChan]);
+
+    for (uint32 iChan = 0; iChan < mRotationChannels.size(); iChan++)
+    {
+        const TRotationChannel& rkKeys = mRotationChannels[iChan];
+        std::vector<uint16>& rOut = mCompressedRotationChannels[iChan];
+        rOut.resize(rkKeys.size() * 3);
+
+        for (uint32 iKey = 0; iKey < rkKeys.size(); iKey++)
+            CompressRotation(rkKeys[iKey], &rOut[iKey * 3]);
+    }
+
+    std::vector<TScaleChannel>().swap(mScaleChannels);
+    std::vector<TRotationChannel>().swap(mRotationChannels);
+    std::vector<TTranslationChannel>().swap(mTranslationChannels);
+}
+
+/** Decompress the keys if they aren't resident, and mark the animation as most recently used.
+ *  Must be called with gResidentMutex locked, and the lock must be held for as long as the keys are read.
+ */
+void CAnimation::ConditionalDecompressKeys() const
+{
+    if (mKeysResident)
+    {
+        gResidentAnims.splice(gResidentAnims.begin(), gResidentAnims, mResidentIter);
+        return;
+    }
+
+    mScaleChannels.resize(mCompressedScaleChannels.size());
+    mRotationChannels.resize(mCompressedRotationChannels.size());
+    mTranslationChannels.resize(mCompressedTranslationChannels.size());
+
+    for (uint32 iChan = 0; iChan < mCompressedScaleChannels.size(); iChan++)
+        DecompressVectorChannel(mCompressedScaleChannels[iChan], mScaleChannels[iChan]);
+
+    for (uint32 iChan = 0; iChan < mCompressedTranslationChannels.size(); iChan++)
+        DecompressVectorChannel(mCompressedTranslationChannels[iChan], mTranslationChannels[iChan]);
+
+    for (uint32 iChan = 0; iChan < mCompressedRotationChannels.size(); iChan++)
+    {
+        const std::vector<uint16>& rkData = mCompressedRotationChannels[iChan];
+        TRotationChannel& rKeys = mRotationChannels[iChan];
+        rKeys.resize(rkData.size() / 3);
+
+        for (uint32 iKey = 0; iKey < rKeys.size(); iKey++)
+            rKeys[iKey] = DecompressRotation(&rkData[iKey * 3]);
+    }
+
+    gResidentAnims.push_front(this);
+    mResidentIter = gResidentAnims.begin();
+    mKeysResident = true;
+    gResidentKeyBytes += DecompressedKeySize();
+
+    // Evict the least recently used animations. The animation being evaluated always stays resident.
+    while (gResidentKeyBytes > gDecompressedKeyBudget && gResidentAnims.back() != this)
+        gResidentAnims.back()->ReleaseDecompressedKeys();
+}
+
+/** Free the decompressed keys. Must be called with gResidentMutex locked. */
+void CAnimation::ReleaseDecompressedKeys() const
+{
+    if (!mKeysResident)
+        return;
+
+    gResidentKeyBytes -= DecompressedKeySize();
+    gResidentAnims.erase(mResidentIter);
+    mKeysResident = false;
+
+    std::vector<TScaleChannel>().swap(mScaleChannels);
+    std::vector<TRotationChannel>().swap(mRotationChannels);
+    std::vector<TTranslationChannel>().swap(mTranslationChannels);
+}
+
+uint32 CAnimation::DecompressedKeySize() const
+{
+    // Count the keys each channel actually decompresses to; channels without keys don't take up any space
+    uint32 NumVectorKeys = 0;
+    uint32 NumRotationKeys = 0;
+
+    for (uint32 iChan = 0; iChan < mCompressedScaleChannels.size(); iChan++)
+        NumVectorKeys += mCompressedScaleChannels[iChan].Keys.size() / 3;
+
+    for (uint32 iChan = 0; iChan < mCompressedTranslationChannels.size(); iChan++)
+        NumVectorKeys += mCompressedTranslationChannels[iChan].Keys.size() / 3;
+
+    for (uint32 iChan = 0; iChan < mCompressedRotationChannels.size(); iChan++)
+        NumRotationKeys += mCompressedRotationChannels[iChan].size() / 3;
+
+    return (NumVectorKeys * sizeof(CVector3f)) + (NumRotationKeys * sizeof(CQuaternion));
+}
+
+void CAnimation::CompressVectorChannel(const std::vector<CVector3f>& rkKeys, SCompressedVectorChannel& rOut)
+{
+    CVector3f Min = (rkKeys.empty() ? CVector3f::skZero : rkKeys[0]);
+    CVector3f Max = Min;
+
+    for (uint32 iKey = 1; iKey < rkKeys.size(); iKey++)
+    {
+        const CVector3f& rkKey = rkKeys[iKey];
+        Min = CVector3f(Math::Min(Min.X, rkKey.X), Math::Min(Min.Y, rkKey.Y), Math::Min(Min.Z, rkKey.Z));
+        Max = CVector3f(Math::Max(Max.X, rkKey.X), Math::Max(Max.Y, rkKey.Y), Math::Max(Max.Z, rkKey.Z));
+    }
+
+    rOut.Base = Min;
+    rOut.Step = (Max - Min) / 65535.f;
+    rOut.Keys.resize(rkKeys.size() * 3);
+
+    const float kMin[3] = { Min.X, Min.Y, Min.Z };
+    const float kStep[3] = { rOut.Step.X, rOut.Step.Y, rOut.Step.Z };
+
+    for (uint32 iKey = 0; iKey < rkKeys.size(); iKey++)
+    {
+        const float kKey[3] = { rkKeys[iKey].X, rkKeys[iKey].Y, rkKeys[iKey].Z };
+
+        for (uint32 iComp = 0; iComp < 3; iComp++)
+        {
+            float Value = (kStep[iComp] > 0.f ? (kKey[iComp] - kMin[iComp]) / kStep[iComp] : 0.f);
+            rOut.Keys[iKey * 3 + iComp] = (uint16) Math::Clamp(0.f, 65535.f, roundf(Value));
+        }
+    }
+}
+
+void CAnimation::DecompressVectorChannel(const SCompressedVectorChannel& rkChannel, std::vector<CVector3f>& rOut)
+{
+    rOut.resize(rkChannel.Keys.size() / 3);
+
+    for (uint32 iKey = 0; iKey < rOut.size(); iKey++)
+    {
+        const uint16 *pkKey = &rkChannel.Keys[iKey * 3];
+        rOut[iKey] = CVector3f(rkChannel.Base.X + rkChannel.Step.X * pkKey[0],
+                               rkChannel.Base.Y + rkChannel.Step.Y * pkKey[1],
+                               rkChannel.Base.Z + rkChannel.Step.Z * pkKey[2]);
+    }
+}
+
+/** Pack a rotation into 48 bits. The largest component is dropped and rebuilt from the other three,
+ *  which are each stored in the top 15 bits of a word. The low bits hold the index of the dropped
+ *  component and its sign, so the quaternion is reproduced exactly as it was, without a sign flip.
+ */
+void CAnimation::CompressRotation(const CQuaternion& rkRot, uint16 *pOut)
+{
+    float Length = Math::Sqrt(rkRot.W * rkRot.W + rkRot.X * rkRot.X + rkRot.Y * rkRot.Y + rkRot.Z * rkRot.Z);
+    float InvLength = (Length > 0.f ? 1.f / Length : 0.f);
+    float Components[4] = { rkRot.W * InvLength, rkRot.X * InvLength, rkRot.Y * InvLength, rkRot.Z * InvLength };
+
+    uint32 Largest = 0;
+
+    for (uint32 iComp = 1; iComp < 4; iComp++)
+    {
+        if (fabsf(Components[iComp]) > fabsf(Components[Largest]))
+            Largest = iComp;
+    }
+
+    uint16 LowBits[3] = { (uint16) (Largest & 0x1), (uint16) (Largest >> 1), (uint16) (Components[Largest] < 0.f ? 1 : 0) };
+    uint32 OutIdx = 0;
+
+    for (uint32 iComp = 0; iComp < 4; iComp++)
+    {
+        if (iComp == Largest) continue;
+
+        // The remaining components are always within [-1/sqrt(2), 1/sqrt(2)]
+        float Normalized = (Components[iComp] * gkSqrt2 * 0.5f) + 0.5f;
+        uint16 Quantized = (uint16) Math::Clamp(0.f, 32767.f, roundf(Normalized * 32767.f));
+        pOut[OutIdx] = (uint16) ((Quantized << 1) | LowBits[OutIdx]);
+        OutIdx++;
+    }
+}
+
+CQuaternion CAnimation::DecompressRotation(const uint16 *pkData)
+{
+    uint32 Largest = (pkData[0] & 0x1) | ((pkData[1] & 0x1) << 1);
+    bool Negative = (pkData[2] & 0x1) != 0;
+
+    float Components[4];
+    float SquaredSum = 0.f;
+    uint32 InIdx = 0;
+
+    for (uint32 iComp = 0; iComp < 4; iComp++)
+    {
+        if (iComp == Largest) continue;
+
+        float Normalized = (float) (pkData[InIdx] >> 1) / 32767.f;
+        Components[iComp] = ((Normalized - 0.5f) * 2.f) / gkSqrt2;
+        SquaredSum += Components[iComp] * Components[iComp];
+        InIdx++;
+    }
+
+    Components[Largest] = Math::Sqrt( fmax(1.f - SquaredSum, 0.f) );
+    if (Negative) Components[Largest] = -Components[Largest];
+
+    CQuaternion Out;
+    Out.W = Components[0];
+    Out.X = Components[1];
+    Out.Y = Components[2];
+    Out.Z = Components[3];
+    return Out;
+}
@@ -6,6 +6,7 @@
 #include "Core/Resource/Animation/CAnimEventData.h"
 #include <Common/Math/CQuaternion.h>
 #include <Common/Math/CVector3f.h>
+#include <list>
 #include <vector>
 
 class CAnimation : public CResource
@@ -21,9 +22,25 @@ class CAnimation : public CResource
     float mTickInterval;
     uint32 mNumKeys;
 
-    std::vector<TScaleChannel> mScaleChannels;
-    std::vector<TRotationChannel> mRotationChannels;
-    std::vector<TTranslationChannel> mTranslationChannels;
+    // Decompressed keys. These are only resident while the animation is being used;
+    // the least recently evaluated animations are evicted once the memory budget is exceeded.
+    mutable std::vector<TScaleChannel> mScaleChannels;
+    mutable std::vector<TRotationChannel> mRotationChannels;
+    mutable std::vector<TTranslationChannel> mTranslationChannels;
+    mutable std::list<const CAnimation*>::iterator mResidentIter;
+    mutable bool mKeysResident;
+
+    // Compressed keys. Vectors are quantized to 16 bits per component over the range of the channel.
+    // Rotations are stored as the three smallest components in 48 bits per key.
+    struct SCompressedVectorChannel
+    {
+        CVector3f Base;
+        CVector3f Step;
+        std::vector<uint16> Keys;
+    };
+    std::vector<SCompressedVectorChannel> mCompressedScaleChannels;
+    std::vector<std::vector<uint16>> mCompressedRotationChannels;
+    std::vector<SCompressedVectorChannel> mCompressedTranslationChannels;
 
     struct SBoneChannelInfo
     {
@@ -35,16 +52,32 @@ class CAnimation : public CResource
 
     TResPtr<CAnimEventData> mpEventData;
 
+    void CompressKeys();
+    void ConditionalDecompressKeys() const;
+    void ReleaseDecompressedKeys() const;
+    uint32 DecompressedKeySize() const;
+
+    static void CompressVectorChannel(const std::vector<CVector3f>& rkKeys, SCompressedVectorChannel& rOut);
+    static void DecompressVectorChannel(const SCompressedVectorChannel& rkChannel, std::vector<CVector3f>& rOut);
+    static void CompressRotation(const CQuaternion& rkRot, uint16 *pOut);
+    static CQuaternion DecompressRotation(const uint16 *pkData);
+
 public:
     CAnimation(CResourceEntry *pEntry = 0);
+    ~CAnimation();
     CDependencyTree* BuildDependencyTree() const;
+    bool FindKeyInterpolation(float Time, uint32& rOutLowKey, float& rOutT) const;
     void EvaluateTransform(float Time, uint32 BoneID, CVector3f *pOutTranslation, CQuaternion *pOutRotation, CVector3f *pOutScale) const;
+    void EvaluatePose(float Time, const std::vector<uint32>& rkBoneIDs, CVector3f *pOutTranslations, CQuaternion *pOutRotations, CVector3f *pOutScales) const;
     bool HasTranslation(uint32 BoneID) const;
 
     inline float Duration() const               { return mDuration; }
     inline uint32 NumKeys() const               { return mNumKeys; }
     inline float TickInterval() const           { return mTickInterval; }
     inline CAnimEventData* EventData() const    { return mpEventData; }
+
+    static void SetDecompressedKeyBudget(uint32 Bytes);
+    static uint32 DecompressedKeyMemory();
 };
 
 #endif // CANIMATION_H
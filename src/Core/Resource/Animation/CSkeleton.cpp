@@ -12,35 +12,6 @@ CBone::CBone(CSkeleton *pSkel)
 {
 }
 
-void CBone::UpdateTransform(CBoneTransformData& rData, const SBoneTransformInfo& rkParentTransform, CAnimation *pAnim, float Time, bool AnchorRoot)
-{
-    // Get transform data
-    SBoneTransformInfo TransformInfo;
-    TransformInfo.Position = mLocalPosition;
-
-    if (pAnim)
-        pAnim->EvaluateTransform(Time, mID, &TransformInfo.Position, &TransformInfo.Rotation, &TransformInfo.Scale);
-
-    if (AnchorRoot && IsRoot())
-        TransformInfo.Position = CVector3f::skZero;
-
-    // Apply parent transform
-    TransformInfo.Position = rkParentTransform.Position + (rkParentTransform.Rotation * (rkParentTransform.Scale * TransformInfo.Position));
-    TransformInfo.Rotation = rkParentTransform.Rotation * TransformInfo.Rotation;
-
-    // Calculate transform
-    CTransform4f& rTransform = rData[mID];
-    rTransform.SetIdentity();
-    rTransform.Scale(TransformInfo.Scale);
-    rTransform.Rotate(TransformInfo.Rotation);
-    rTransform.Translate(TransformInfo.Position);
-    rTransform *= mInvBind;
-
-    // Calculate children
-    for (uint32 iChild = 0; iChild < mChildren.size(); iChild++)
-        mChildren[iChild]->UpdateTransform(rData, TransformInfo, pAnim, Time, AnchorRoot);
-}
-
 CVector3f CBone::TransformedPosition(const CBoneTransformData& rkData) const
 {
     return rkData[mID] * Position();
@@ -109,10 +80,97 @@ uint32 CSkeleton::MaxBoneID() const
     return ID;
 }
 
+void CSkeleton::BuildEvaluationOrder()
+{
+    mEvalBoneIDs.clear();
+    mEvalParents.clear();
+    mEvalIsRoot.clear();
+    mEvalLocalPositions.clear();
+    mEvalInvBinds.clear();
+
+    if (!mpRootBone)
+        return;
+
+    // Depth-first, so every bone comes after its parent
+    std::vector< std::pair<CBone*, int32> > Stack;
+    Stack.emplace_back(mpRootBone, -1);
+
+    while (!Stack.empty())
+    {
+        CBone *pBone = Stack.back().first;
+        int32 ParentIdx = Stack.back().second;
+        Stack.pop_back();
+
+        int32 Index = (int32) mEvalBoneIDs.size();
+        mEvalBoneIDs.push_back(pBone->mID);
+        mEvalParents.push_back(ParentIdx);
+        mEvalIsRoot.push_back(pBone->IsRoot() ? 1 : 0);
+        mEvalLocalPositions.push_back(pBone->mLocalPosition);
+        mEvalInvBinds.push_back(pBone->mInvBind);
+
+        for (uint32 iChild = pBone->mChildren.size(); iChild > 0; iChild--)
+            Stack.emplace_back(pBone->mChildren[iChild - 1], Index);
+    }
+}
+
 void CSkeleton::UpdateTransform(CBoneTransformData& rData, CAnimation *pAnim, float Time, bool AnchorRoot)
 {
     ASSERT(rData.NumTrackedBones() >= MaxBoneID());
-    mpRootBone->UpdateTransform(rData, SBoneTransformInfo(), pAnim, Time, AnchorRoot);
+
+    // Per-bone pose data, indexed by evaluation order. Reused between calls to avoid allocating every frame.
+    static thread_local std::vector<CVector3f> sPositions;
+    static thread_local std::vector<CQuaternion> sRotations;
+    static thread_local std::vector<CVector3f> sScales;
+
+    const uint32 kNumBones = mEvalBoneIDs.size();
+    sPositions.assign(mEvalLocalPositions.begin(), mEvalLocalPositions.end());
+    sRotations.assign(kNumBones, CQuaternion::skIdentity);
+    sScales.assign(kNumBones, CVector3f::skOne);
+
+    // Sample local transforms for every bone at once
+    if (pAnim)
+        pAnim->EvaluatePose(Time, mEvalBoneIDs, sPositions.data(), sRotations.data(), sScales.data());
+
+    for (uint32 iBone = 0; iBone < kNumBones; iBone++)
+    {
+        if (AnchorRoot && mEvalIsRoot[iBone])
+            sPositions[iBone] = CVector3f::skZero;
+
+        // Apply parent transform. Parents always come first, so they've already been converted to model space.
+        int32 ParentIdx = mEvalParents[iBone];
+
+        if (ParentIdx >= 0)
+        {
+            const CQuaternion& rkParentRot = sRotations[ParentIdx];
+            sPositions[iBone] = sPositions[ParentIdx] + (rkParentRot * (sScales[ParentIdx] * sPositions[iBone]));
+            sRotations[iBone] = rkParentRot * sRotations[iBone];
+        }
+
+        // Build the scale/rotate/translate matrix directly instead of multiplying out separate matrices
+        const CQuaternion& rkRot = sRotations[iBone];
+        const CVector3f& rkScale = sScales[iBone];
+        const CVector3f& rkPos = sPositions[iBone];
+
+        float XX = rkRot.X * rkRot.X, YY = rkRot.Y * rkRot.Y, ZZ = rkRot.Z * rkRot.Z;
+        float XY = rkRot.X * rkRot.Y, XZ = rkRot.X * rkRot.Z, YZ = rkRot.Y * rkRot.Z;
+        float WX = rkRot.W * rkRot.X, WY = rkRot.W * rkRot.Y, WZ = rkRot.W * rkRot.Z;
+
+        CTransform4f Transform;
+        Transform[0][0] = (1.f - 2.f * (YY + ZZ)) * rkScale.X;
+        Transform[0][1] = (2.f * (XY - WZ)) * rkScale.Y;
+        Transform[0][2] = (2.f * (XZ + WY)) * rkScale.Z;
+        Transform[0][3] = rkPos.X;
+        Transform[1][0] = (2.f * (XY + WZ)) * rkScale.X;
+        Transform[1][1] = (1.f - 2.f * (XX + ZZ)) * rkScale.Y;
+        Transform[1][2] = (2.f * (YZ - WX)) * rkScale.Z;
+        Transform[1][3] = rkPos.Y;
+        Transform[2][0] = (2.f * (XZ - WY)) * rkScale.X;
+        Transform[2][1] = (2.f * (YZ + WX)) * rkScale.Y;
+        Transform[2][2] = (1.f - 2.f * (XX + YY)) * rkScale.Z;
+        Transform[2][3] = rkPos.Z;
+
+        rData[ mEvalBoneIDs[iBone] ] = Transform * mEvalInvBinds[iBone];
+    }
 }
 
 void CSkeleton::Draw(FRenderOptions /*Options*/, const CBoneTransformData *pkData)
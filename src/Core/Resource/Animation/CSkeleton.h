@@ -7,21 +7,12 @@
 #include <Common/BasicTypes.h>
 #include <Common/TString.h>
 #include <Common/Math/CRay.h>
+#include <Common/Math/CTransform4f.h>
 #include <Common/Math/CVector3f.h>
 
 class CBoneTransformData;
 class CBone;
 
-struct SBoneTransformInfo
-{
-    CVector3f Position;
-    CQuaternion Rotation;
-    CVector3f Scale;
-
-    SBoneTransformInfo()
-        : Position(CVector3f::skZero), Rotation(CQuaternion::skIdentity), Scale(CVector3f::skOne) {}
-};
-
 class CSkeleton : public CResource
 {
     DECLARE_RESOURCE_TYPE(Skeleton)
@@ -30,8 +21,18 @@ class CSkeleton : public CResource
     CBone *mpRootBone;
     std::vector<CBone*> mBones;
 
+    // Bone hierarchy flattened into parent-before-child order, for evaluating poses without recursion.
+    // Parent indices refer to positions in this order; -1 means the bone has no parent.
+    std::vector<uint32> mEvalBoneIDs;
+    std::vector<int32> mEvalParents;
+    std::vector<uint8> mEvalIsRoot;
+    std::vector<CVector3f> mEvalLocalPositions;
+    std::vector<CTransform4f> mEvalInvBinds;
+
     static const float skSphereRadius;
 
+    void BuildEvaluationOrder();
+
 public:
     CSkeleton(CResourceEntry *pEntry = 0);
     ~CSkeleton();
@@ -49,6 +50,7 @@ public:
 
 class CBone
 {
+    friend class CSkeleton;
     friend class CSkeletonLoader;
 
     CSkeleton *mpSkeleton;
@@ -65,7 +67,6 @@ class CBone
 
 public:
     CBone(CSkeleton *pSkel);
-    void UpdateTransform(CBoneTransformData& rData, const SBoneTransformInfo& rkParentTransform, CAnimation *pAnim, float Time, bool AnchorRoot);
     CVector3f TransformedPosition(const CBoneTransformData& rkData) const;
     CQuaternion TransformedRotation(const CBoneTransformData& rkData) const;
     bool IsRoot() const;
@@ -4,6 +4,8 @@
 #include "Core/Render/CRenderer.h"
 #include "Core/OpenGL/GLCommon.h"
 #include "Core/OpenGL/CShaderGenerator.h"
+#include "Core/OpenGL/NShaderCache.h"
+#include "Core/OpenGL/NShaderPregen.h"
 #include <Common/Hash/CFNV1A.h>
 
 #include <iostream>
@@ -104,18 +106,39 @@ void CMaterial::GenerateShader(bool AllowRegen /*= true*/)
         {
             SMaterialShader& rShader = Find->second;
 
-            if (rShader.pShader == mpShader)
-                return;
+            if (rShader.pShader != mpShader)
+            {
+                ClearShader();
+                mpShader = rShader.pShader;
+                rShader.NumReferences++;
+            }
 
-            ClearShader();
-            mpShader = rShader.pShader;
-            rShader.NumReferences++;
+            mShaderStatus = EShaderStatus::ShaderExists;
         }
 
         else
         {
             ClearShader();
-            mpShader = CShaderGenerator::GenerateShader(*this);
+
+            // If the shader is queued for background generation, wait for it rather than stalling to generate it here
+            if (NShaderPregen::IsShaderQueued(mParametersHash))
+                return;
+
+            // Check for a shader that was generated in the background, then the persistent shader cache
+            mpShader = NShaderPregen::TakeShader(mParametersHash);
+
+            if (!mpShader)
+                mpShader = NShaderCache::LoadShader(mParametersHash);
+
+            if (!mpShader)
+            {
+                TString VertexSource = CShaderGenerator::GenerateVertexSource(*this);
+                TString PixelSource = CShaderGenerator::GeneratePixelSource(*this);
+                mpShader = new CShader(*VertexSource, *PixelSource);
+
+                if (mpShader->IsValidProgram())
+                    NShaderCache::StoreShader(mParametersHash, VertexSource, PixelSource, mpShader);
+            }
 
             if (!mpShader->IsValidProgram())
             {
@@ -163,11 +186,13 @@ bool CMaterial::SetCurrent(FRenderOptions Options)
     {
         // Shader setup
         if (mShaderStatus == EShaderStatus::NoShader) GenerateShader();
-        mpShader->SetCurrent();
 
-        if (mShaderStatus == EShaderStatus::ShaderFailed)
+        // The shader may have failed to compile, or still be queued for background generation
+        if (mShaderStatus != EShaderStatus::ShaderExists)
             return false;
 
+        mpShader->SetCurrent();
+
         // Set RGB blend equation - force to ZERO/ONE if alpha is disabled
         GLenum srcRGB, dstRGB, srcAlpha, dstAlpha;
 
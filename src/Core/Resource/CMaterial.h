@@ -116,6 +116,7 @@ public:
 
     // Static
     inline static void KillCachedMaterial() { sCurrentMaterial = 0; }
+    inline static bool IsShaderLoaded(uint64 ParametersHash) { return smShaderMap.find(ParametersHash) != smShaderMap.end(); }
 };
 
 #endif // MATERIAL_H
@@ -1,13 +1,15 @@
 #include "CAreaCooker.h"
 #include "CScriptCooker.h"
 #include "Core/CompressionUtil.h"
+#include "Core/GameProject/CGameProject.h"
 #include "Core/GameProject/DependencyListBuilders.h"
 #include <Common/Log.h>
 
 const bool gkForceDisableCompression = false;
 
 CAreaCooker::CAreaCooker()
-    : mGeometrySecNum(-1)
+    : mCookProfile(ECookProfile::Max)
+    , mGeometrySecNum(-1)
     , mSCLYSecNum(-1)
     , mSCGNSecNum(-1)
     , mCollisionSecNum(-1)
@@ -349,16 +351,16 @@ void CAreaCooker::FinishBlock()
 {
     if (mCurBlock.NumSections == 0) return;
 
-    std::vector<uint8> CompressedBuf(mCompressedData.Size() * 2);
-    bool EnableCompression = (mVersion >= EGame::Echoes) && mpArea->mUsesCompression && !gkForceDisableCompression;
+    bool EnableCompression = (mVersion >= EGame::Echoes) && mpArea->mUsesCompression && !gkForceDisableCompression && (mCookProfile != ECookProfile::Fast);
     bool UseZlib = (mVersion == EGame::DKCReturns);
+    std::vector<uint8> CompressedBuf(EnableCompression ? CompressionUtil::CompressSegmentedBound(mCompressedData.Size(), UseZlib, true) : 0);
 
     uint32 CompressedSize = 0;
     bool WriteCompressedData = false;
 
     if (EnableCompression)
     {
-        bool Success = CompressionUtil::CompressSegmentedData((uint8*) mCompressedData.Data(), mCompressedData.Size(), CompressedBuf.data(), CompressedSize, UseZlib, true);
+        bool Success = CompressionUtil::CompressSegmentedData((uint8*) mCompressedData.Data(), mCompressedData.Size(), CompressedBuf.data(), CompressedSize, UseZlib, true, mCookProfile);
         uint32 PadBytes = (32 - (CompressedSize % 32)) & 0x1F;
         WriteCompressedData = Success && (CompressedSize + PadBytes < (uint32) mCompressedData.Size());
     }
@@ -394,6 +396,9 @@ bool CAreaCooker::CookMREA(CGameArea *pArea, IOutputStream& rOut)
     Cooker.mpArea = pArea;
     Cooker.mVersion = pArea->Game();
 
+    CGameProject *pProj = (pArea->Entry() ? pArea->Entry()->Project() : nullptr);
+    if (pProj) Cooker.mCookProfile = pProj->CookProfile();
+
     if (Cooker.mVersion <= EGame::Echoes)
         Cooker.DetermineSectionNumbersPrime();
     else
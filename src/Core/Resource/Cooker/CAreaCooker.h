@@ -2,6 +2,7 @@
 #define CAREACOOKER_H
 
 #include "CSectionMgrOut.h"
+#include "Core/CompressionUtil.h"
 #include "Core/Resource/Area/CGameArea.h"
 #include <Common/EGame.h>
 #include <Common/FileIO.h>
@@ -10,6 +11,7 @@ class CAreaCooker
 {
     TResPtr<CGameArea> mpArea;
     EGame mVersion;
+    ECookProfile mCookProfile;
 
     std::vector<uint32> mSectionSizes;
 
@@ -5,123 +5,149 @@
 #include <Core/Resource/Script/Property/CEnumProperty.h>
 #include <Core/Resource/Script/Property/CFlagsProperty.h>
 
-void CScriptCooker::WriteProperty(IOutputStream& rOut, IProperty* pProperty, bool InAtomicStruct)
+/** Write the property ID and a placeholder size, if needed. Returns the offset of the size, or 0 if there isn't one. */
+uint32 CScriptCooker::BeginProperty(IOutputStream& rOut, uint32 ID, bool InAtomicStruct)
 {
-    uint32 SizeOffset = 0, PropStart = 0;
-    void* pData = (mpArrayItemData ? mpArrayItemData : mpObject->PropertyData());
-
     if (mGame >= EGame::EchoesDemo && !InAtomicStruct)
     {
-        rOut.WriteLong(pProperty->ID());
-        SizeOffset = rOut.Tell();
+        rOut.WriteLong(ID);
+        uint32 SizeOffset = rOut.Tell();
         rOut.WriteShort(0x0);
-        PropStart = rOut.Tell();
+        return SizeOffset;
     }
 
-    switch (pProperty->Type())
+    return 0;
+}
+
+/** Fill in the size of a property started with BeginProperty */
+void CScriptCooker::EndProperty(IOutputStream& rOut, uint32 SizeOffset)
+{
+    if (SizeOffset != 0)
+    {
+        uint32 PropStart = SizeOffset + 2;
+        uint32 PropEnd = rOut.Tell();
+        rOut.Seek(SizeOffset, SEEK_SET);
+        rOut.WriteShort((uint16) (PropEnd - PropStart));
+        rOut.Seek(PropEnd, SEEK_SET);
+    }
+}
+
+void CScriptCooker::WriteProperty(IOutputStream& rOut, IProperty* pProperty, bool InAtomicStruct)
+{
+    uint32 SizeOffset = BeginProperty(rOut, pProperty->ID(), InAtomicStruct);
+    WritePropertyValue(rOut, pProperty, pProperty->Type());
+    EndProperty(rOut, SizeOffset);
+}
+
+void CScriptCooker::WritePropertyValue(IOutputStream& rOut, IProperty* pProperty, EPropertyType Type)
+{
+    void* pData = (mpArrayItemData ? mpArrayItemData : mpObject->PropertyData());
+
+    // The caller has already looked up the property type, so we can cast without checking it again
+    switch (Type)
     {
 
     case EPropertyType::Bool:
     {
-        CBoolProperty* pBool = TPropCast<CBoolProperty>(pProperty);
+        CBoolProperty* pBool = static_cast<CBoolProperty*>(pProperty);
         rOut.WriteBool( pBool->Value(pData) );
         break;
     }
 
     case EPropertyType::Byte:
     {
-        CByteProperty* pByte = TPropCast<CByteProperty>(pProperty);
+        CByteProperty* pByte = static_cast<CByteProperty*>(pProperty);
         rOut.WriteByte( pByte->Value(pData) );
         break;
     }
 
     case EPropertyType::Short:
     {
-        CShortProperty* pShort = TPropCast<CShortProperty>(pProperty);
+        CShortProperty* pShort = static_cast<CShortProperty*>(pProperty);
         rOut.WriteShort( pShort->Value(pData) );
         break;
     }
 
     case EPropertyType::Int:
     {
-        CIntProperty* pInt = TPropCast<CIntProperty>(pProperty);
+        CIntProperty* pInt = static_cast<CIntProperty*>(pProperty);
         rOut.WriteLong( pInt->Value(pData) );
         break;
     }
 
     case EPropertyType::Float:
     {
-        CFloatProperty* pFloat = TPropCast<CFloatProperty>(pProperty);
+        CFloatProperty* pFloat = static_cast<CFloatProperty*>(pProperty);
         rOut.WriteFloat( pFloat->Value(pData) );
         break;
     }
 
     case EPropertyType::Choice:
     {
-        CChoiceProperty* pChoice = TPropCast<CChoiceProperty>(pProperty);
+        CChoiceProperty* pChoice = static_cast<CChoiceProperty*>(pProperty);
         rOut.WriteLong( pChoice->Value(pData) );
         break;
     }
 
     case EPropertyType::Enum:
     {
-        CEnumProperty* pEnum = TPropCast<CEnumProperty>(pProperty);
+        CEnumProperty* pEnum = static_cast<CEnumProperty*>(pProperty);
         rOut.WriteLong( pEnum->Value(pData) );
         break;
     }
 
     case EPropertyType::Flags:
     {
-        CFlagsProperty* pFlags = TPropCast<CFlagsProperty>(pProperty);
+        CFlagsProperty* pFlags = static_cast<CFlagsProperty*>(pProperty);
         rOut.WriteLong( pFlags->Value(pData) );
         break;
     }
 
     case EPropertyType::String:
     {
-        CStringProperty* pString = TPropCast<CStringProperty>(pProperty);
+        CStringProperty* pString = static_cast<CStringProperty*>(pProperty);
         rOut.WriteString( pString->Value(pData) );
         break;
     }
 
     case EPropertyType::Vector:
     {
-        CVectorProperty* pVector = TPropCast<CVectorProperty>(pProperty);
+        CVectorProperty* pVector = static_cast<CVectorProperty*>(pProperty);
         pVector->ValueRef(pData).Write(rOut);
         break;
     }
 
     case EPropertyType::Color:
     {
-        CColorProperty* pColor = TPropCast<CColorProperty>(pProperty);
+        CColorProperty* pColor = static_cast<CColorProperty*>(pProperty);
         pColor->ValueRef(pData).Write(rOut);
         break;
     }
 
     case EPropertyType::Asset:
     {
-        CAssetProperty* pAsset = TPropCast<CAssetProperty>(pProperty);
+        CAssetProperty* pAsset = static_cast<CAssetProperty*>(pProperty);
         pAsset->ValueRef(pData).Write(rOut);
         break;
     }
 
     case EPropertyType::Sound:
     {
-        CSoundProperty* pSound = TPropCast<CSoundProperty>(pProperty);
+        CSoundProperty* pSound = static_cast<CSoundProperty*>(pProperty);
         rOut.WriteLong( pSound->Value(pData) );
         break;
     }
 
     case EPropertyType::Animation:
     {
-        CAnimationProperty* pAnim = TPropCast<CAnimationProperty>(pProperty);
+        CAnimationProperty* pAnim = static_cast<CAnimationProperty*>(pProperty);
         rOut.WriteLong( pAnim->Value(pData) );
         break;
     }
 
     case EPropertyType::AnimationSet:
     {
-        CAnimationSetProperty* pAnimSet = TPropCast<CAnimationSetProperty>(pProperty);
+        CAnimationSetProperty* pAnimSet = static_cast<CAnimationSetProperty*>(pProperty);
         pAnimSet->ValueRef(pData).Write(rOut);
         break;
     }
@@ -134,7 +160,7 @@ void CScriptCooker::WriteProperty(IOutputStream& rOut, IProperty* pProperty, boo
 
     case EPropertyType::Spline:
     {
-        CSplineProperty* pSpline = TPropCast<CSplineProperty>(pProperty);
+        CSplineProperty* pSpline = static_cast<CSplineProperty*>(pProperty);
         std::vector<char>& rBuffer = pSpline->ValueRef(pData);
 
         if (!rBuffer.empty())
@@ -165,7 +191,7 @@ void CScriptCooker::WriteProperty(IOutputStream& rOut, IProperty* pProperty, boo
 
     case EPropertyType::Guid:
     {
-        CGuidProperty* pGuid = TPropCast<CGuidProperty>(pProperty);
+        CGuidProperty* pGuid = static_cast<CGuidProperty*>(pProperty);
         std::vector<char>& rBuffer = pGuid->ValueRef(pData);
 
         if (rBuffer.empty())
@@ -177,7 +203,7 @@ void CScriptCooker::WriteProperty(IOutputStream& rOut, IProperty* pProperty, boo
 
     case EPropertyType::Struct:
     {
-        CStructProperty* pStruct = TPropCast<CStructProperty>(pProperty);
+        CStructProperty* pStruct = static_cast<CStructProperty*>(pProperty);
         std::vector<IProperty*> PropertiesToWrite;
 
         for (uint32 ChildIdx = 0; ChildIdx < pStruct->NumChildren(); ChildIdx++)
@@ -204,7 +230,7 @@ void CScriptCooker::WriteProperty(IOutputStream& rOut, IProperty* pProperty, boo
 
     case EPropertyType::Array:
     {
-        CArrayProperty* pArray = TPropCast<CArrayProperty>(pProperty);
+        CArrayProperty* pArray = static_cast<CArrayProperty*>(pProperty);
         uint32 Count = pArray->ArrayCount(pData);
         rOut.WriteLong(Count);
 
@@ -221,14 +247,76 @@ void CScriptCooker::WriteProperty(IOutputStream& rOut, IProperty* pProperty, boo
     }
 
     }
+}
 
-    if (SizeOffset != 0)
+void CScriptCooker::WritePlanProperty(IOutputStream& rOut, uint32 OpIndex, bool InAtomicStruct)
+{
+    const CPropertyPlan::SOp& rkOp = mpPlan->Op(OpIndex);
+    uint32 SizeOffset = BeginProperty(rOut, rkOp.ID, InAtomicStruct);
+
+    if (rkOp.Type == EPropertyType::Struct)
     {
-        uint32 PropEnd = rOut.Tell();
-        rOut.Seek(SizeOffset, SEEK_SET);
-        rOut.WriteShort((uint16) (PropEnd - PropStart));
-        rOut.Seek(PropEnd, SEEK_SET);
+        void* pData = (mpArrayItemData ? mpArrayItemData : mpObject->PropertyData());
+        uint32 CountOffset = rOut.Tell();
+        uint32 NumWritten = 0;
+
+        // The property count isn't known until we check which properties should be cooked, so fill it in afterward
+        if (!rkOp.Atomic)
+        {
+            if (mGame <= EGame::Prime)
+                rOut.WriteLong(0);
+            else
+                rOut.WriteShort(0);
+        }
+
+        for (uint32 ChildOp = mpPlan->FirstChild(OpIndex); ChildOp < rkOp.SubtreeEnd; ChildOp = mpPlan->NextSibling(ChildOp))
+        {
+            const CPropertyPlan::SOp& rkChild = mpPlan->Op(ChildOp);
+
+            if (rkOp.Atomic || rkChild.pProperty->ShouldCook(pData))
+            {
+                WritePlanProperty(rOut, ChildOp, rkOp.Atomic);
+                NumWritten++;
+            }
+        }
+
+        if (!rkOp.Atomic)
+        {
+            uint32 StructEnd = rOut.Tell();
+            rOut.Seek(CountOffset, SEEK_SET);
+
+            if (mGame <= EGame::Prime)
+                rOut.WriteLong(NumWritten);
+            else
+                rOut.WriteShort((uint16) NumWritten);
+
+            rOut.Seek(StructEnd, SEEK_SET);
+        }
+    }
+
+    else if (rkOp.Type == EPropertyType::Array)
+    {
+        void* pData = (mpArrayItemData ? mpArrayItemData : mpObject->PropertyData());
+        CArrayProperty* pArray = static_cast<CArrayProperty*>(rkOp.pProperty);
+        uint32 Count = pArray->ArrayCount(pData);
+        rOut.WriteLong(Count);
+
+        void* pOldItemData = mpArrayItemData;
+        uint32 ItemOp = mpPlan->FirstChild(OpIndex);
+
+        for (uint32 ElementIdx = 0; ElementIdx < Count; ElementIdx++)
+        {
+            mpArrayItemData = pArray->ItemPointer(pData, ElementIdx);
+            WritePlanProperty(rOut, ItemOp, true);
+        }
+
+        mpArrayItemData = pOldItemData;
     }
+
+    else
+        WritePropertyValue(rOut, rkOp.pProperty, rkOp.Type);
+
+    EndProperty(rOut, SizeOffset);
 }
 
 // ************ PUBLIC ************
@@ -262,7 +350,12 @@ void CScriptCooker::WriteInstance(IOutputStream& rOut, CScriptObject *pInstance)
     }
 
     mpObject = pInstance;
+#if USE_PROPERTY_PLANS
+    mpPlan = pInstance->Template()->PropertyPlan();
+    WritePlanProperty(rOut, 0, false);
+#else
     WriteProperty(rOut, pInstance->Template()->Properties(), false);
+#endif
     uint32 InstanceEnd = rOut.Tell();
 
     rOut.Seek(SizeOffset, SEEK_SET);
@@ -2,6 +2,7 @@
 #define CSCRIPTCOOKER_H
 
 #include "CSectionMgrOut.h"
+#include "Core/Resource/Script/CPropertyPlan.h"
 #include "Core/Resource/Script/CScriptLayer.h"
 #include "Core/Resource/Script/CScriptObject.h"
 #include <Common/EGame.h>
@@ -11,16 +12,22 @@ class CScriptCooker
 {
     EGame mGame;
     CScriptObject* mpObject;
+    const CPropertyPlan* mpPlan;
     void* mpArrayItemData;
     std::vector<CScriptObject*> mGeneratedObjects;
     bool mWriteGeneratedSeparately;
 
+    uint32 BeginProperty(IOutputStream& rOut, uint32 ID, bool InAtomicStruct);
+    void EndProperty(IOutputStream& rOut, uint32 SizeOffset);
     void WriteProperty(IOutputStream& rOut, IProperty* pProperty, bool InAtomicStruct);
+    void WritePropertyValue(IOutputStream& rOut, IProperty* pProperty, EPropertyType Type);
+    void WritePlanProperty(IOutputStream& rOut, uint32 OpIndex, bool InAtomicStruct);
 
 public:
     CScriptCooker(EGame Game, bool WriteGeneratedObjectsSeparately = true)
         : mGame(Game)
         , mpObject(nullptr)
+        , mpPlan(nullptr)
         , mpArrayItemData(nullptr)
         , mWriteGeneratedSeparately(WriteGeneratedObjectsSeparately && mGame >= EGame::EchoesDemo)
     {}
@@ -1,4 +1,5 @@
 #include "CWorldCooker.h"
+#include "Core/CWorkerPool.h"
 #include "Core/GameProject/DependencyListBuilders.h"
 
 CWorldCooker::CWorldCooker()
@@ -68,6 +69,31 @@ bool CWorldCooker::CookMLVL(CWorld *pWorld, IOutputStream& rMLVL)
     if (Game <= EGame::Prime) rMLVL.WriteLong(1); // Unknown
     std::set<CAssetID> AudioGroups;
 
+    // Build area dependency lists up front. Areas are independent of each other and building the lists only
+    // reads the resource store and the entries' existing dependency trees, so they're evaluated in parallel.
+    struct SAreaDependencies
+    {
+        std::list<CAssetID> Assets;
+        std::list<uint32> LayerOffsets;
+        std::set<CAssetID> AudioGroups;
+    };
+    std::vector<SAreaDependencies> AreaDependencies;
+
+    if (Game <= EGame::Echoes)
+    {
+        AreaDependencies.resize(pWorld->mAreas.size());
+
+        CWorkerPool::Shared()->ParallelFor(pWorld->mAreas.size(), [&](uint32 AreaIdx)
+        {
+            CResourceEntry *pAreaEntry = gpResourceStore->FindEntry(pWorld->mAreas[AreaIdx].AreaResID);
+            ASSERT(pAreaEntry && pAreaEntry->ResourceType() == EResourceType::Area);
+            SAreaDependencies& rDeps = AreaDependencies[AreaIdx];
+
+            CAreaDependencyListBuilder Builder(pAreaEntry);
+            Builder.BuildDependencyList(rDeps.Assets, rDeps.LayerOffsets, &rDeps.AudioGroups);
+        });
+    }
+
     for (uint32 iArea = 0; iArea < pWorld->mAreas.size(); iArea++)
     {
         // Area Header
@@ -94,10 +120,9 @@ bool CWorldCooker::CookMLVL(CWorld *pWorld, IOutputStream& rMLVL)
         // Dependencies
         if (Game <= EGame::Echoes)
         {
-            std::list<CAssetID> Dependencies;
-            std::list<uint32> LayerDependsOffsets;
-            CAreaDependencyListBuilder Builder(pAreaEntry);
-            Builder.BuildDependencyList(Dependencies, LayerDependsOffsets, &AudioGroups);
+            const std::list<CAssetID>& Dependencies = AreaDependencies[iArea].Assets;
+            const std::list<uint32>& LayerDependsOffsets = AreaDependencies[iArea].LayerOffsets;
+            AudioGroups.insert(AreaDependencies[iArea].AudioGroups.begin(), AreaDependencies[iArea].AudioGroups.end());
 
             rMLVL.WriteLong(0);
             rMLVL.WriteLong( Dependencies.size() );
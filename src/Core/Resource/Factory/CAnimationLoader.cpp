@@ -306,145 +306,210 @@ void CAnimationLoader::ReadCompressedANIM()
     ReadCompressedAnimationData();
 }
 
+/** Fill in keys that aren't present in the file by interpolating between the surrounding keys */
+template<typename KeyType, typename InterpFunc>
+static void InterpolateMissingKeys(std::vector<KeyType>& rKeys, const std::vector<bool>& kKeyFlags, InterpFunc Interpolate)
+{
+    uint32 NumMissedKeys = 0;
+
+    for (uint32 iKey = 0; iKey < kKeyFlags.size(); iKey++)
+    {
+        if (!kKeyFlags[iKey])
+            NumMissedKeys++;
+
+        else if (NumMissedKeys > 0)
+        {
+            uint32 FirstIndex = iKey - NumMissedKeys - 1;
+            uint32 LastIndex = iKey;
+            uint32 RelLastIndex = LastIndex - FirstIndex;
+
+            for (uint32 iMissed = 0; iMissed < NumMissedKeys; iMissed++)
+            {
+                uint32 KeyIndex = FirstIndex + iMissed + 1;
+                uint32 RelKeyIndex = (KeyIndex - FirstIndex);
+                float Interp = (float) RelKeyIndex / (float) RelLastIndex;
+                rKeys[KeyIndex] = Interpolate(rKeys[FirstIndex], rKeys[LastIndex], Interp);
+            }
+
+            NumMissedKeys = 0;
+        }
+    }
+}
+
+CAnimationLoader::SBitField CAnimationLoader::MakeBitField(uint32& rKeyOffset, uint32 NumBits, bool Signed)
+{
+    SBitField Field;
+    Field.KeyOffset = rKeyOffset;
+    Field.Mask = (uint32) ((1ULL << NumBits) - 1);
+    Field.SignBit = (Signed && NumBits > 0 ? 1u << (NumBits - 1) : 0);
+    rKeyOffset += NumBits;
+    return Field;
+}
+
+int16 CAnimationLoader::UnpackBitField(const std::vector<uint32>& kWords, uint32 KeyStart, const SBitField& kField)
+{
+    // Bits are packed starting from the low bit of each word, so a field can be pulled out of a
+    // 64-bit window over two consecutive words. The word buffer is padded so the window never overruns.
+    uint32 Bit = KeyStart + kField.KeyOffset;
+    uint32 WordIdx = Bit >> 5;
+    uint64 Window = kWords[WordIdx] | ((uint64) kWords[WordIdx + 1] << 32);
+    uint32 Value = (uint32) (Window >> (Bit & 31)) & kField.Mask;
+
+    if (Value & kField.SignBit)
+        Value |= ~kField.Mask;
+
+    return (int16) Value;
+}
+
 void CAnimationLoader::ReadCompressedAnimationData()
 {
-    CBitStreamInWrapper BitStream(mpInput);
+    const uint32 kNumKeys = mpAnim->mNumKeys;
+    if (kNumKeys == 0) return;
+
+    // Every key that is present has the same layout, so precompute where each field is within a key.
+    // This matches the order the fields are read from the bitstream in: for each channel, the rotation
+    // W sign and XYZ, then the translation XYZ, then the scale XYZ.
+    struct SChannelLayout
+    {
+        SBitField RotationSign;
+        SBitField Rotation[3];
+        SBitField Translation[3];
+        SBitField Scale[3];
+    };
+    std::vector<SChannelLayout> Layouts(mCompressedChannels.size());
+    uint32 KeyBits = 0;
 
-    // Initialize
     for (uint32 iChan = 0; iChan < mCompressedChannels.size(); iChan++)
     {
-        SCompressedChannel& rChan = mCompressedChannels[iChan];
+        const SCompressedChannel& kChan = mCompressedChannels[iChan];
+        SChannelLayout& rLayout = Layouts[iChan];
 
-        // Set initial rotation/translation/scale
-        if (rChan.NumRotationKeys > 0)
+        if (kChan.NumRotationKeys > 0)
         {
-            mpAnim->mRotationChannels[iChan].reserve(rChan.NumRotationKeys + 1);
-            CQuaternion Rotation = DequantizeRotation(false, rChan.Rotation[0], rChan.Rotation[1], rChan.Rotation[2]);
-            mpAnim->mRotationChannels[iChan].push_back(Rotation);
+            rLayout.RotationSign = MakeBitField(KeyBits, 1, false);
+
+            for (uint32 iComp = 0; iComp < 3; iComp++)
+                rLayout.Rotation[iComp] = MakeBitField(KeyBits, kChan.RotationBits[iComp], true);
         }
 
-        if (rChan.NumTranslationKeys > 0)
+        if (kChan.NumTranslationKeys > 0)
         {
-            mpAnim->mTranslationChannels[iChan].reserve(rChan.NumTranslationKeys + 1);
-            CVector3f Translate = CVector3f(rChan.Translation[0], rChan.Translation[1], rChan.Translation[2]) * mTranslationMultiplier;
-            mpAnim->mTranslationChannels[iChan].push_back(Translate);
+            for (uint32 iComp = 0; iComp < 3; iComp++)
+                rLayout.Translation[iComp] = MakeBitField(KeyBits, kChan.TranslationBits[iComp], true);
         }
 
-        if (rChan.NumScaleKeys > 0)
+        if (kChan.NumScaleKeys > 0)
         {
-            mpAnim->mScaleChannels[iChan].reserve(rChan.NumScaleKeys + 1);
-            CVector3f Scale = CVector3f(rChan.Scale[0], rChan.Scale[1], rChan.Scale[2]) * mScaleMultiplier;
-            mpAnim->mScaleChannels[iChan].push_back(Scale);
+            for (uint32 iComp = 0; iComp < 3; iComp++)
+                rLayout.Scale[iComp] = MakeBitField(KeyBits, kChan.ScaleBits[iComp], true);
         }
     }
 
-    // Read keys
-    for (uint32 iKey = 0; iKey < mpAnim->mNumKeys - 1; iKey++)
+    // Find where each key starts in the bitstream. The first key is stored in the channel headers,
+    // and keys that aren't present have no data.
+    std::vector<uint32> KeyStarts(kNumKeys, 0);
+    uint32 TotalBits = 0;
+
+    for (uint32 iKey = 1; iKey < kNumKeys; iKey++)
+    {
+        KeyStarts[iKey] = TotalBits;
+        if (mKeyFlags[iKey]) TotalBits += KeyBits;
+    }
+
+    // Read the whole bitstream up front, with an extra word of padding for the unpacker
+    uint32 NumWords = (TotalBits + 31) / 32;
+    std::vector<uint32> Words(NumWords + 1, 0);
+
+    for (uint32 iWord = 0; iWord < NumWords; iWord++)
+        Words[iWord] = mpInput->ReadLong();
+
+    // Decode keys, one channel at a time
+    for (uint32 iChan = 0; iChan < mCompressedChannels.size(); iChan++)
     {
-        bool KeyPresent = mKeyFlags[iKey+1];
+        const SCompressedChannel& kChan = mCompressedChannels[iChan];
+        const SChannelLayout& kLayout = Layouts[iChan];
 
-        for (uint32 iChan = 0; iChan < mCompressedChannels.size(); iChan++)
+        if (kChan.NumRotationKeys > 0)
         {
-            SCompressedChannel& rChan = mCompressedChannels[iChan];
+            std::vector<CQuaternion>& rKeys = mpAnim->mRotationChannels[iChan];
+            rKeys.resize(kNumKeys);
 
-            // Read rotation
-            if (rChan.NumRotationKeys > 0)
+            int16 X = kChan.Rotation[0], Y = kChan.Rotation[1], Z = kChan.Rotation[2];
+            rKeys[0] = DequantizeRotation(false, X, Y, Z);
+
+            for (uint32 iKey = 1; iKey < kNumKeys; iKey++)
             {
-                // Note if KeyPresent is false, this isn't the correct value of WSign.
+                // Note if the key isn't present, this isn't the correct value of WSign.
                 // However, we're going to recreate this key later via interpolation, so it doesn't matter what value we use here.
-                bool WSign = (KeyPresent ? BitStream.ReadBit() : false);
+                bool WSign = false;
 
-                if (KeyPresent)
+                if (mKeyFlags[iKey])
                 {
-                    rChan.Rotation[0] += (int16) BitStream.ReadBits(rChan.RotationBits[0]);
-                    rChan.Rotation[1] += (int16) BitStream.ReadBits(rChan.RotationBits[1]);
-                    rChan.Rotation[2] += (int16) BitStream.ReadBits(rChan.RotationBits[2]);
+                    uint32 Start = KeyStarts[iKey];
+                    WSign = (UnpackBitField(Words, Start, kLayout.RotationSign) != 0);
+                    X += UnpackBitField(Words, Start, kLayout.Rotation[0]);
+                    Y += UnpackBitField(Words, Start, kLayout.Rotation[1]);
+                    Z += UnpackBitField(Words, Start, kLayout.Rotation[2]);
                 }
 
-                CQuaternion Rotation = DequantizeRotation(WSign, rChan.Rotation[0], rChan.Rotation[1], rChan.Rotation[2]);
-                mpAnim->mRotationChannels[iChan].push_back(Rotation);
+                rKeys[iKey] = DequantizeRotation(WSign, X, Y, Z);
             }
 
-            // Read translation
-            if (rChan.NumTranslationKeys > 0)
-            {
-                if (KeyPresent)
-                {
-                    rChan.Translation[0] += (int16) BitStream.ReadBits(rChan.TranslationBits[0]);
-                    rChan.Translation[1] += (int16) BitStream.ReadBits(rChan.TranslationBits[1]);
-                    rChan.Translation[2] += (int16) BitStream.ReadBits(rChan.TranslationBits[2]);
-                }
+            InterpolateMissingKeys(rKeys, mKeyFlags, [](const CQuaternion& kLeft, const CQuaternion& kRight, float Interp) {
+                return kLeft.Slerp(kRight, Interp);
+            });
+        }
 
-                CVector3f Translate = CVector3f(rChan.Translation[0], rChan.Translation[1], rChan.Translation[2]) * mTranslationMultiplier;
-                mpAnim->mTranslationChannels[iChan].push_back(Translate);
-            }
+        if (kChan.NumTranslationKeys > 0)
+        {
+            std::vector<CVector3f>& rKeys = mpAnim->mTranslationChannels[iChan];
+            rKeys.resize(kNumKeys);
 
-            // Read scale
-            if (rChan.NumScaleKeys > 0)
+            int16 X = kChan.Translation[0], Y = kChan.Translation[1], Z = kChan.Translation[2];
+            rKeys[0] = CVector3f(X, Y, Z) * mTranslationMultiplier;
+
+            for (uint32 iKey = 1; iKey < kNumKeys; iKey++)
             {
-                if (KeyPresent)
+                if (mKeyFlags[iKey])
                 {
-                    rChan.Scale[0] += (int16) BitStream.ReadBits(rChan.ScaleBits[0]);
-                    rChan.Scale[1] += (int16) BitStream.ReadBits(rChan.ScaleBits[1]);
-                    rChan.Scale[2] += (int16) BitStream.ReadBits(rChan.ScaleBits[2]);
+                    uint32 Start = KeyStarts[iKey];
+                    X += UnpackBitField(Words, Start, kLayout.Translation[0]);
+                    Y += UnpackBitField(Words, Start, kLayout.Translation[1]);
+                    Z += UnpackBitField(Words, Start, kLayout.Translation[2]);
                 }
 
-                CVector3f Scale = CVector3f(rChan.Scale[0], rChan.Scale[1], rChan.Scale[2]) * mScaleMultiplier;
-                mpAnim->mScaleChannels[iChan].push_back(Scale);
+                rKeys[iKey] = CVector3f(X, Y, Z) * mTranslationMultiplier;
             }
-        }
-    }
 
-    // Fill in missing keys
-    uint32 NumMissedKeys = 0;
-
-    for (uint32 iKey = 0; iKey < mpAnim->mNumKeys; iKey++)
-    {
-        if (!mKeyFlags[iKey])
-            NumMissedKeys++;
+            InterpolateMissingKeys(rKeys, mKeyFlags, [](const CVector3f& kLeft, const CVector3f& kRight, float Interp) {
+                return Math::Lerp<CVector3f>(kLeft, kRight, Interp);
+            });
+        }
 
-        else if (NumMissedKeys > 0)
+        if (kChan.NumScaleKeys > 0)
         {
-            uint32 FirstIndex = iKey - NumMissedKeys - 1;
-            uint32 LastIndex = iKey;
-            uint32 RelLastIndex = LastIndex - FirstIndex;
+            std::vector<CVector3f>& rKeys = mpAnim->mScaleChannels[iChan];
+            rKeys.resize(kNumKeys);
 
-            for (uint32 iMissed = 0; iMissed < NumMissedKeys; iMissed++)
-            {
-                uint32 KeyIndex = FirstIndex + iMissed + 1;
-                uint32 RelKeyIndex = (KeyIndex - FirstIndex);
-                float Interp = (float) RelKeyIndex / (float) RelLastIndex;
+            int16 X = kChan.Scale[0], Y = kChan.Scale[1], Z = kChan.Scale[2];
+            rKeys[0] = CVector3f(X, Y, Z) * mScaleMultiplier;
 
-                for (uint32 iChan = 0; iChan < mCompressedChannels.size(); iChan++)
+            for (uint32 iKey = 1; iKey < kNumKeys; iKey++)
+            {
+                if (mKeyFlags[iKey])
                 {
-                    bool HasTranslationKeys = mCompressedChannels[iChan].NumTranslationKeys > 0;
-                    bool HasRotationKeys = mCompressedChannels[iChan].NumRotationKeys > 0;
-                    bool HasScaleKeys = mCompressedChannels[iChan].NumScaleKeys > 0;
-
-                    if (HasRotationKeys)
-                    {
-                        CQuaternion Left = mpAnim->mRotationChannels[iChan][FirstIndex];
-                        CQuaternion Right = mpAnim->mRotationChannels[iChan][LastIndex];
-                        mpAnim->mRotationChannels[iChan][KeyIndex] = Left.Slerp(Right, Interp);
-                    }
-
-                    if (HasTranslationKeys)
-                    {
-                        CVector3f Left = mpAnim->mTranslationChannels[iChan][FirstIndex];
-                        CVector3f Right = mpAnim->mTranslationChannels[iChan][LastIndex];
-                        mpAnim->mTranslationChannels[iChan][KeyIndex] = Math::Lerp<CVector3f>(Left, Right, Interp);
-                    }
-
-                    if (HasScaleKeys)
-                    {
-                        CVector3f Left = mpAnim->mScaleChannels[iChan][FirstIndex];
-                        CVector3f Right = mpAnim->mScaleChannels[iChan][LastIndex];
-                        mpAnim->mScaleChannels[iChan][KeyIndex] = Math::Lerp<CVector3f>(Left, Right, Interp);
-                    }
+                    uint32 Start = KeyStarts[iKey];
+                    X += UnpackBitField(Words, Start, kLayout.Scale[0]);
+                    Y += UnpackBitField(Words, Start, kLayout.Scale[1]);
+                    Z += UnpackBitField(Words, Start, kLayout.Scale[2]);
                 }
+
+                rKeys[iKey] = CVector3f(X, Y, Z) * mScaleMultiplier;
             }
 
-            NumMissedKeys = 0;
+            InterpolateMissingKeys(rKeys, mKeyFlags, [](const CVector3f& kLeft, const CVector3f& kRight, float Interp) {
+                return Math::Lerp<CVector3f>(kLeft, kRight, Interp);
+            });
         }
     }
 }
@@ -486,5 +551,6 @@ CAnimation* CAnimationLoader::LoadANIM(IInputStream& rANIM, CResourceEntry *pEnt
     else
         Loader.ReadCompressedANIM();
 
+    Loader.mpAnim->CompressKeys();
     return Loader.mpAnim;
 }
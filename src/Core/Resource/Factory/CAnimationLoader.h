@@ -32,12 +32,22 @@ class CAnimationLoader
     };
     std::vector<SCompressedChannel> mCompressedChannels;
 
+    /** Location of a packed value within a single key of compressed animation data */
+    struct SBitField
+    {
+        uint32 KeyOffset;
+        uint32 Mask;
+        uint32 SignBit;
+    };
+
     CAnimationLoader() {}
     bool UncompressedCheckEchoes();
     EGame UncompressedCheckVersion();
     void ReadUncompressedANIM();
     void ReadCompressedANIM();
     void ReadCompressedAnimationData();
+    static SBitField MakeBitField(uint32& rKeyOffset, uint32 NumBits, bool Signed);
+    static int16 UnpackBitField(const std::vector<uint32>& kWords, uint32 KeyStart, const SBitField& kField);
     CQuaternion DequantizeRotation(bool Sign, int16 X, int16 Y, int16 Z);
 
 public:
@@ -4,6 +4,7 @@
 #include "CMaterialLoader.h"
 #include "CScriptLoader.h"
 #include "Core/CompressionUtil.h"
+#include "Core/OpenGL/NShaderPregen.h"
 #include <Common/Log.h>
 
 #include <Common/CFourCC.h>
@@ -808,6 +809,19 @@ CGameArea* CAreaLoader::LoadMREA(IInputStream& MREA, CResourceEntry *pEntry)
             return nullptr;
     }
 
+    // Start generating shaders for the area's materials in the background, so they're ready by the time it's drawn
+    CMaterialSet* pMaterials = Loader.mpArea->mpMaterialSet;
+
+    if (pMaterials)
+    {
+        std::vector<CMaterial*> Materials(pMaterials->NumMaterials());
+
+        for (uint32 MatIdx = 0; MatIdx < Materials.size(); MatIdx++)
+            Materials[MatIdx] = pMaterials->MaterialByIndex(MatIdx);
+
+        NShaderPregen::QueueMaterials(Materials);
+    }
+
     // Cleanup
     delete Loader.mpSectionMgr;
     return Loader.mpArea;
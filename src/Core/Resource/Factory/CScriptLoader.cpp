@@ -15,55 +15,57 @@
 
 CScriptLoader::CScriptLoader()
     : mpObj(nullptr)
+    , mpPlan(nullptr)
     , mpArrayItemData(nullptr)
 {
 }
 
-void CScriptLoader::ReadProperty(IProperty *pProp, uint32 Size, IInputStream& rSCLY)
+void CScriptLoader::ReadProperty(IProperty *pProp, EPropertyType Type, uint32 Size, IInputStream& rSCLY)
 {
     void* pData = (mpArrayItemData ? mpArrayItemData : mpObj->mPropertyData.data());
 
-    switch (pProp->Type())
+    // The caller has already looked up the property type, so we can cast without checking it again
+    switch (Type)
     {
 
     case EPropertyType::Bool:
     {
-        CBoolProperty* pBool = TPropCast<CBoolProperty>(pProp);
+        CBoolProperty* pBool = static_cast<CBoolProperty*>(pProp);
         pBool->ValueRef(pData) = rSCLY.ReadBool();
         break;
     }
 
     case EPropertyType::Byte:
     {
-        CByteProperty* pByte = TPropCast<CByteProperty>(pProp);
+        CByteProperty* pByte = static_cast<CByteProperty*>(pProp);
         pByte->ValueRef(pData) = rSCLY.ReadByte();
         break;
     }
 
     case EPropertyType::Short:
     {
-        CShortProperty* pShort = TPropCast<CShortProperty>(pProp);
+        CShortProperty* pShort = static_cast<CShortProperty*>(pProp);
         pShort->ValueRef(pData) = rSCLY.ReadShort();
         break;
     }
 
     case EPropertyType::Int:
     {
-        CIntProperty* pInt = TPropCast<CIntProperty>(pProp);
+        CIntProperty* pInt = static_cast<CIntProperty*>(pProp);
         pInt->ValueRef(pData) = rSCLY.ReadLong();
         break;
     }
 
     case EPropertyType::Float:
     {
-        CFloatProperty* pFloat = TPropCast<CFloatProperty>(pProp);
+        CFloatProperty* pFloat = static_cast<CFloatProperty*>(pProp);
         pFloat->ValueRef(pData) = rSCLY.ReadFloat();
         break;
     }
 
     case EPropertyType::Choice:
     {
-        CChoiceProperty* pChoice = TPropCast<CChoiceProperty>(pProp);
+        CChoiceProperty* pChoice = static_cast<CChoiceProperty*>(pProp);
         pChoice->ValueRef(pData) = rSCLY.ReadLong();
 
 #if VALIDATE_PROPERTY_VALUES
@@ -83,7 +85,7 @@ void CScriptLoader::ReadProperty(IProperty *pProp, uint32 Size, IInputStream& rS
 
     case EPropertyType::Enum:
     {
-        CEnumProperty* pEnum = TPropCast<CEnumProperty>(pProp);
+        CEnumProperty* pEnum = static_cast<CEnumProperty*>(pProp);
         pEnum->ValueRef(pData) = rSCLY.ReadLong();
 
 #if VALIDATE_PROPERTY_VALUES
@@ -103,7 +105,7 @@ void CScriptLoader::ReadProperty(IProperty *pProp, uint32 Size, IInputStream& rS
 
     case EPropertyType::Flags:
     {
-        CFlagsProperty* pFlags = TPropCast<CFlagsProperty>(pProp);
+        CFlagsProperty* pFlags = static_cast<CFlagsProperty*>(pProp);
         pFlags->ValueRef(pData) = rSCLY.ReadLong();
 
 #if VALIDATE_PROPERTY_VALUES
@@ -124,28 +126,28 @@ void CScriptLoader::ReadProperty(IProperty *pProp, uint32 Size, IInputStream& rS
 
     case EPropertyType::String:
     {
-        CStringProperty* pString = TPropCast<CStringProperty>(pProp);
+        CStringProperty* pString = static_cast<CStringProperty*>(pProp);
         pString->ValueRef(pData) = rSCLY.ReadString();
         break;
     }
 
     case EPropertyType::Vector:
     {
-        CVectorProperty* pVector = TPropCast<CVectorProperty>(pProp);
+        CVectorProperty* pVector = static_cast<CVectorProperty*>(pProp);
         pVector->ValueRef(pData) = CVector3f(rSCLY);
         break;
     }
 
     case EPropertyType::Color:
     {
-        CColorProperty* pColor = TPropCast<CColorProperty>(pProp);
+        CColorProperty* pColor = static_cast<CColorProperty*>(pProp);
         pColor->ValueRef(pData) = CColor(rSCLY);
         break;
     }
 
     case EPropertyType::Asset:
     {
-        CAssetProperty* pAsset = TPropCast<CAssetProperty>(pProp);
+        CAssetProperty* pAsset = static_cast<CAssetProperty*>(pProp);
         pAsset->ValueRef(pData) = CAssetID(rSCLY, mpGameTemplate->Game());
 
 #if VALIDATE_PROPERTY_VALUES
@@ -177,21 +179,21 @@ void CScriptLoader::ReadProperty(IProperty *pProp, uint32 Size, IInputStream& rS
 
     case EPropertyType::Sound:
     {
-        CSoundProperty* pSound = TPropCast<CSoundProperty>(pProp);
+        CSoundProperty* pSound = static_cast<CSoundProperty*>(pProp);
         pSound->ValueRef(pData) = rSCLY.ReadLong();
         break;
     }
 
     case EPropertyType::Animation:
     {
-        CAnimationProperty* pAnim = TPropCast<CAnimationProperty>(pProp);
+        CAnimationProperty* pAnim = static_cast<CAnimationProperty*>(pProp);
         pAnim->ValueRef(pData) = rSCLY.ReadLong();
         break;
     }
 
     case EPropertyType::AnimationSet:
     {
-        CAnimationSetProperty* pAnimSet = TPropCast<CAnimationSetProperty>(pProp);
+        CAnimationSetProperty* pAnimSet = static_cast<CAnimationSetProperty*>(pProp);
         pAnimSet->ValueRef(pData) = CAnimationParameters(rSCLY, mpGameTemplate->Game());
         break;
     }
@@ -204,7 +206,7 @@ void CScriptLoader::ReadProperty(IProperty *pProp, uint32 Size, IInputStream& rS
 
     case EPropertyType::Spline:
     {
-        CSplineProperty* pSpline = TPropCast<CSplineProperty>(pProp);
+        CSplineProperty* pSpline = static_cast<CSplineProperty*>(pProp);
         std::vector<char>& Buffer = pSpline->ValueRef(pData);
         Buffer.resize(Size);
         rSCLY.ReadBytes(Buffer.data(), Buffer.size());
@@ -214,7 +216,7 @@ void CScriptLoader::ReadProperty(IProperty *pProp, uint32 Size, IInputStream& rS
     case EPropertyType::Guid:
     {
         ASSERT(Size == 16);
-        CGuidProperty* pGuid = TPropCast<CGuidProperty>(pProp);
+        CGuidProperty* pGuid = static_cast<CGuidProperty*>(pProp);
         pGuid->ValueRef(pData).resize(16);
         rSCLY.ReadBytes(pGuid->ValueRef(pData).data(), 16);
         break;
@@ -222,7 +224,7 @@ void CScriptLoader::ReadProperty(IProperty *pProp, uint32 Size, IInputStream& rS
 
     case EPropertyType::Struct:
     {
-        CStructProperty* pStruct = TPropCast<CStructProperty>(pProp);
+        CStructProperty* pStruct = static_cast<CStructProperty*>(pProp);
 
         if (mVersion < EGame::EchoesDemo)
             LoadStructMP1(rSCLY, pStruct);
@@ -233,7 +235,7 @@ void CScriptLoader::ReadProperty(IProperty *pProp, uint32 Size, IInputStream& rS
 
     case EPropertyType::Array:
     {
-        CArrayProperty *pArray = TPropCast<CArrayProperty>(pProp);
+        CArrayProperty *pArray = static_cast<CArrayProperty*>(pProp);
         int Count = rSCLY.ReadLong();
 
         pArray->Resize(pData, Count);
@@ -258,7 +260,7 @@ void CScriptLoader::ReadProperty(IProperty *pProp, uint32 Size, IInputStream& rS
              * things to make this cleaner
              */
             mpArrayItemData = pArray->ItemPointer(pData, ElementIdx);
-            ReadProperty(pArray->ItemArchetype(), 0, rSCLY);
+            ReadProperty(pArray->ItemArchetype(), pArray->ItemArchetype()->Type(), 0, rSCLY);
         }
 
         mpArrayItemData = pOldArrayItemData;
@@ -268,6 +270,42 @@ void CScriptLoader::ReadProperty(IProperty *pProp, uint32 Size, IInputStream& rS
     }
 }
 
+void CScriptLoader::ReadPlanProperty(uint32 OpIndex, uint32 Size, IInputStream& rSCLY)
+{
+    const CPropertyPlan::SOp& rkOp = mpPlan->Op(OpIndex);
+
+    if (rkOp.Type == EPropertyType::Struct)
+    {
+        if (mVersion < EGame::EchoesDemo)
+            LoadPlanStructMP1(rSCLY, OpIndex);
+        else
+            LoadPlanStructMP2(rSCLY, OpIndex);
+    }
+
+    else if (rkOp.Type == EPropertyType::Array)
+    {
+        // See ReadProperty for notes on how array items are handled
+        void* pData = (mpArrayItemData ? mpArrayItemData : mpObj->mPropertyData.data());
+        CArrayProperty *pArray = static_cast<CArrayProperty*>(rkOp.pProperty);
+        int Count = rSCLY.ReadLong();
+
+        pArray->Resize(pData, Count);
+        void* pOldArrayItemData = mpArrayItemData;
+        uint32 ItemOp = mpPlan->FirstChild(OpIndex);
+
+        for (int ElementIdx = 0; ElementIdx < Count; ElementIdx++)
+        {
+            mpArrayItemData = pArray->ItemPointer(pData, ElementIdx);
+            ReadPlanProperty(ItemOp, 0, rSCLY);
+        }
+
+        mpArrayItemData = pOldArrayItemData;
+    }
+
+    else
+        ReadProperty(rkOp.pProperty, rkOp.Type, Size, rSCLY);
+}
+
 void CScriptLoader::LoadStructMP1(IInputStream& rSCLY, CStructProperty* pStruct)
 {
     uint32 StructStart = rSCLY.Tell();
@@ -289,7 +327,22 @@ void CScriptLoader::LoadStructMP1(IInputStream& rSCLY, CStructProperty* pStruct)
 
         //@todo version check
         if (pProperty->CookPreference() != ECookPreference::Never)
-            ReadProperty(pProperty, 0, rSCLY);
+            ReadProperty(pProperty, pProperty->Type(), 0, rSCLY);
+    }
+}
+
+void CScriptLoader::LoadPlanStructMP1(IInputStream& rSCLY, uint32 StructOp)
+{
+    const CPropertyPlan::SOp& rkStruct = mpPlan->Op(StructOp);
+
+    // Property count; @todo version checking
+    if (!rkStruct.Atomic)
+        rSCLY.Skip(4);
+
+    for (uint32 ChildOp = mpPlan->FirstChild(StructOp); ChildOp < rkStruct.SubtreeEnd; ChildOp = mpPlan->NextSibling(ChildOp))
+    {
+        if (mpPlan->Op(ChildOp).CookPreference != ECookPreference::Never)
+            ReadPlanProperty(ChildOp, 0, rSCLY);
     }
 }
 
@@ -328,8 +381,13 @@ CScriptObject* CScriptLoader::LoadObjectMP1(IInputStream& rSCLY)
     }
 
     // Load object...
+#if USE_PROPERTY_PLANS
+    mpPlan = pTemplate->PropertyPlan();
+    LoadPlanStructMP1(rSCLY, 0);
+#else
     CStructProperty* pProperties = pTemplate->Properties();
     LoadStructMP1(rSCLY, pProperties);
+#endif
 
     // Cleanup and return
     rSCLY.Seek(End, SEEK_SET);
@@ -393,7 +451,56 @@ void CScriptLoader::LoadStructMP2(IInputStream& rSCLY, CStructProperty* pStruct)
         if (!pProperty)
             errorf("%s [0x%X]: Can't find template for property 0x%08X - skipping", *rSCLY.GetSourceString(), PropertyStart, PropertyID);
         else
-            ReadProperty(pProperty, PropertySize, rSCLY);
+            ReadProperty(pProperty, pProperty->Type(), PropertySize, rSCLY);
+
+        if (NextProperty > 0)
+            rSCLY.Seek(NextProperty, SEEK_SET);
+    }
+}
+
+void CScriptLoader::LoadPlanStructMP2(IInputStream& rSCLY, uint32 StructOp)
+{
+    const CPropertyPlan::SOp& rkStruct = mpPlan->Op(StructOp);
+    uint32 ChildCount = rkStruct.NumChildren;
+
+    if (!rkStruct.Atomic)
+        ChildCount = rSCLY.ReadShort();
+
+    // Properties are almost always cooked in template order, so check the next op in the plan
+    // before falling back to searching the struct for the property ID
+    uint32 ExpectedOp = mpPlan->FirstChild(StructOp);
+
+    for (uint32 ChildIdx = 0; ChildIdx < ChildCount; ChildIdx++)
+    {
+        uint32 OpIndex = CPropertyPlan::skInvalidOp;
+        uint32 PropertyStart = rSCLY.Tell();
+        uint32 PropertyID = -1;
+        uint16 PropertySize = 0;
+        uint32 NextProperty = 0;
+
+        if (rkStruct.Atomic)
+        {
+            OpIndex = ExpectedOp;
+        }
+        else
+        {
+            PropertyID = rSCLY.ReadLong();
+            PropertySize = rSCLY.ReadShort();
+            NextProperty = rSCLY.Tell() + PropertySize;
+
+            if (ExpectedOp < rkStruct.SubtreeEnd && mpPlan->Op(ExpectedOp).ID == PropertyID)
+                OpIndex = ExpectedOp;
+            else
+                OpIndex = mpPlan->FindChild(StructOp, PropertyID);
+        }
+
+        if (OpIndex == CPropertyPlan::skInvalidOp)
+            errorf("%s [0x%X]: Can't find template for property 0x%08X - skipping", *rSCLY.GetSourceString(), PropertyStart, PropertyID);
+        else
+        {
+            ReadPlanProperty(OpIndex, PropertySize, rSCLY);
+            ExpectedOp = mpPlan->NextSibling(OpIndex);
+        }
 
         if (NextProperty > 0)
             rSCLY.Seek(NextProperty, SEEK_SET);
@@ -436,7 +543,13 @@ CScriptObject* CScriptLoader::LoadObjectMP2(IInputStream& rSCLY)
 
     // Load object
     rSCLY.Seek(0x6, SEEK_CUR); // Skip base struct ID + size
+
+#if USE_PROPERTY_PLANS
+    mpPlan = pTemplate->PropertyPlan();
+    LoadPlanStructMP2(rSCLY, 0);
+#else
     LoadStructMP2(rSCLY, pTemplate->Properties());
+#endif
 
     // Cleanup and return
     rSCLY.Seek(ObjEnd, SEEK_SET);
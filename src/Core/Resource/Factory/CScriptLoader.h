@@ -6,6 +6,7 @@
 #include "Core/Resource/Script/CScriptObject.h"
 #include "Core/Resource/Script/CScriptLayer.h"
 #include "Core/Resource/Script/CGameTemplate.h"
+#include "Core/Resource/Script/CPropertyPlan.h"
 
 class CScriptLoader
 {
@@ -14,18 +15,22 @@ class CScriptLoader
     CScriptLayer* mpLayer;
     CGameArea* mpArea;
     CGameTemplate *mpGameTemplate;
+    const CPropertyPlan* mpPlan;
 
     // Current array item pointer
     void* mpArrayItemData;
 
     CScriptLoader();
-    void ReadProperty(IProperty* pProp, uint32 Size, IInputStream& rSCLY);
+    void ReadProperty(IProperty* pProp, EPropertyType Type, uint32 Size, IInputStream& rSCLY);
+    void ReadPlanProperty(uint32 OpIndex, uint32 Size, IInputStream& rSCLY);
 
     void LoadStructMP1(IInputStream& rSCLY, CStructProperty* pStruct);
+    void LoadPlanStructMP1(IInputStream& rSCLY, uint32 StructOp);
     CScriptObject* LoadObjectMP1(IInputStream& rSCLY);
     CScriptLayer* LoadLayerMP1(IInputStream& rSCLY);
 
     void LoadStructMP2(IInputStream& rSCLY, CStructProperty* pStruct);
+    void LoadPlanStructMP2(IInputStream& rSCLY, uint32 StructOp);
     CScriptObject* LoadObjectMP2(IInputStream& rSCLY);
     CScriptLayer* LoadLayerMP2(IInputStream& rSCLY);
 
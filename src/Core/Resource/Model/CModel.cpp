@@ -145,7 +145,8 @@ void CModel::DrawSurface(FRenderOptions Options, uint32 Surface, uint32 MatSet)
         if (!Options.HasFlag(ERenderOption::EnableOccluders) && pMat->Options().HasFlag(EMaterialOption::Occluder))
             return;
 
-        pMat->SetCurrent(Options);
+        if (!pMat->SetCurrent(Options))
+            return;
     }
 
     // Draw IBOs
@@ -43,6 +43,7 @@ public:
     bool IsSurfaceTransparent(uint32 Surface, uint32 MatSet);
     bool IsLightmapped() const;
 
+    inline CSkin* Skin() const          { return mpSkin; }
     inline bool IsSkinned() const       { return (mpSkin != nullptr); }
 
 private:
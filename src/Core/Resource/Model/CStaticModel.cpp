@@ -109,7 +109,11 @@ void CStaticModel::Draw(FRenderOptions Options)
 {
     if (!mBuffered) BufferGL();
 
-    if ((Options & ERenderOption::NoMaterialSetup) == 0) mpMaterial->SetCurrent(Options);
+    if ((Options & ERenderOption::NoMaterialSetup) == 0)
+    {
+        if (!mpMaterial->SetCurrent(Options))
+            return;
+    }
 
     // Draw IBOs
     mVBO.Bind();
@@ -131,9 +135,14 @@ void CStaticModel::DrawSurface(FRenderOptions Options, uint32 Surface)
 {
     if (!mBuffered) BufferGL();
 
+    if ((Options & ERenderOption::NoMaterialSetup) == 0)
+    {
+        if (!mpMaterial->SetCurrent(Options))
+            return;
+    }
+
     mVBO.Bind();
     glLineWidth(1.f);
-    if ((Options & ERenderOption::NoMaterialSetup) == 0) mpMaterial->SetCurrent(Options);
 
     for (uint32 iIBO = 0; iIBO < mIBOs.size(); iIBO++)
     {
@@ -1,7 +1,10 @@
 #include "CGameTemplate.h"
 #include "NPropertyMap.h"
+#include "NTemplateCache.h"
 #include "Core/Resource/Factory/CWorldLoader.h"
 #include <Common/Log.h>
+#include "Core/CWorkerPool.h"
+#include <Common/Serialization/Binary.h>
 
 CGameTemplate::CGameTemplate()
     : mFullyLoaded(false)
@@ -19,73 +22,440 @@ void CGameTemplate::Serialize(IArchive& Arc)
 
 void CGameTemplate::Load(const TString& kFilePath)
 {
-    CXMLReader Reader(kFilePath);
+    mSourceFile = kFilePath;
+
+    // If the compiled template cache is up to date, only the template index is loaded here,
+    // and templates are loaded from the cache the first time they're needed. Otherwise, parse
+    // the source XMLs and rebuild the cache so the next startup can skip XML parsing.
+    if (!Internal_LoadFromCache())
+    {
+        Internal_LoadFromXML();
+        Internal_SaveCache();
+    }
+}
+
+void CGameTemplate::Save()
+{
+    debugf("Saving game template: %s", *mSourceFile);
+    CXMLWriter Writer(mSourceFile, "Game", 0, mGame);
+    ASSERT(Writer.IsValid());
+    Serialize(Writer);
+    mDirty = false;
+}
+
+/** Internal function for loading a property template, either from cached data or from its source XML. */
+void CGameTemplate::Internal_LoadPropertyTemplate(SPropertyTemplatePath& Path)
+{
+    if (Path.pTemplate != nullptr) // don't load twice
+        return;
+
+    if (!Path.CachedData.empty())
+    {
+        CMemoryInStream DataStream(Path.CachedData.data(), Path.CachedData.size(), EEndian::BigEndian);
+        CBinaryReader Reader(&DataStream, CSerialVersion(IArchive::skCurrentArchiveVersion, 0, mGame));
+        Reader << SerialParameter("PropertyArchetype", Path.pTemplate);
+    }
+    else
+    {
+        const TString kGameDir = GetGameDirectory();
+        const TString kTemplateFilePath = kGameDir + Path.Path;
+        std::unique_ptr<CXMLReader> pReader = Internal_TakePreparsedXML(kTemplateFilePath);
+
+        if (!pReader)
+            pReader = std::make_unique<CXMLReader>(kTemplateFilePath);
+
+        ASSERT(pReader->IsValid());
+        *pReader << SerialParameter("PropertyArchetype", Path.pTemplate);
+    }
+
+    ASSERT(Path.pTemplate != nullptr);
+    std::vector<char>().swap(Path.CachedData);
+
+    Path.pTemplate->Initialize(nullptr, nullptr, 0);
+}
+
+/** Internal function for fetching an XML file that was parsed ahead of time by LoadAllTemplates. */
+std::unique_ptr<CXMLReader> CGameTemplate::Internal_TakePreparsedXML(const TString& kFilePath)
+{
+    std::unique_ptr<CXMLReader> pReader;
+    auto Find = mPreparsedXML.find(kFilePath);
+
+    if (Find != mPreparsedXML.end())
+    {
+        pReader = std::move(Find->second);
+        mPreparsedXML.erase(Find);
+    }
+
+    return pReader;
+}
+
+/** Internal function for creating the (unloaded) script templates listed in the game template. */
+void CGameTemplate::Internal_CreateScriptTemplates()
+{
+    const TString kGameDir = GetGameDirectory();
+
+    for (auto Iter = mScriptTemplates.begin(); Iter != mScriptTemplates.end(); Iter++)
+    {
+        SScriptTemplatePath& ScriptPath = Iter->second;
+        TString AbsPath = kGameDir + ScriptPath.Path;
+        ScriptPath.pTemplate = std::make_shared<CScriptTemplate>(this, Iter->first, AbsPath);
+    }
+}
+
+/** Internal function for loading the game template and all sub-templates from the source XML files. */
+void CGameTemplate::Internal_LoadFromXML()
+{
+    CXMLReader Reader(mSourceFile);
     ASSERT(Reader.IsValid());
 
     mGame = Reader.Game();
     Serialize(Reader);
+    mFullyLoaded = true;
 
-    mSourceFile = kFilePath;
+    // Everything needs to be loaded in order to build the template cache.
+    Internal_CreateScriptTemplates();
+    LoadAllTemplates();
+}
+
+/** Internal function for loading the template index from the compiled template cache.
+ *  Script templates and property archetypes are left unloaded, with their compiled data
+ *  ready to be loaded the first time they're needed.
+ *  Returns false if the cache doesn't exist or is out of date with the source XMLs.
+ */
+bool CGameTemplate::Internal_LoadFromCache()
+{
+    const TString kCachePath = Internal_CachePath();
+
+    if (!FileUtil::Exists(kCachePath))
+        return false;
+
+    std::vector<char> CacheData;
+    {
+        CFileInStream File(kCachePath, EEndian::BigEndian);
+
+        if (!File.IsValid())
+            return false;
+
+        CacheData.resize(File.Size());
+        File.ReadBytes(CacheData.data(), CacheData.size());
+    }
+
+    // Header is magic, cache version, archive version, game, and index size
+    if (CacheData.size() < 0x14)
+    {
+        warnf("Template cache is truncated, loading from XML: %s", *kCachePath);
+        return false;
+    }
+
+    CMemoryInStream Cache(CacheData.data(), CacheData.size(), EEndian::BigEndian);
+    uint32 Magic = Cache.ReadLong();
+    uint32 CacheVersion = Cache.ReadLong();
+    uint32 ArchiveVersion = Cache.ReadLong();
+    EGame CacheGame = (EGame) Cache.ReadLong();
+
+    if (Magic != FOURCC('TMPC') || CacheVersion != NTemplateCache::gkCacheVersion || ArchiveVersion != IArchive::skCurrentArchiveVersion)
+    {
+        debugf("Template cache version mismatch, loading from XML: %s", *kCachePath);
+        return false;
+    }
+
+    // Read the index; this contains the cache header, the game template itself, and the list of compiled templates.
+    const CSerialVersion kVersion(IArchive::skCurrentArchiveVersion, 0, CacheGame);
+    std::vector<TString> ArchetypeNames;
+    std::vector<uint32> ScriptObjectIDs;
+    std::vector<TString> ScriptObjectNames;
+
+    uint32 IndexSize = Cache.ReadLong();
+    uint32 IndexStart = Cache.Tell();
+
+    if (IndexSize > CacheData.size() - IndexStart)
+    {
+        warnf("Template cache index is out of bounds, loading from XML: %s", *kCachePath);
+        return false;
+    }
+
+    {
+        CMemoryInStream IndexStream(&CacheData[IndexStart], IndexSize, EEndian::BigEndian);
+        CBinaryReader Index(&IndexStream, kVersion);
+
+        // Validate the cache against the source files before reading anything else
+        NTemplateCache::SCacheHeader Header;
+        Index << SerialParameter("Header", Header);
+
+        if (!NTemplateCache::IsCacheUpToDate(GetGameDirectory(), Header))
+        {
+            debugf("Template cache is out of date, loading from XML: %s", *kCachePath);
+            return false;
+        }
+
+        debugf("Loading game template from cache: %s", *kCachePath);
+        mGame = CacheGame;
+        Serialize(Index);
+
+        Index << SerialParameter("CachedArchetypes", ArchetypeNames)
+              << SerialParameter("CachedScriptTemplates", ScriptObjectIDs)
+              << SerialParameter("CachedScriptTemplateNames", ScriptObjectNames);
+    }
+    Cache.Seek(IndexStart + IndexSize, SEEK_SET);
+
+    // Make sure the index matches the template data before handing anything out. A corrupt cache
+    // is discarded and the game template is reloaded from XML instead.
+    bool Valid = (ScriptObjectNames.size() == ScriptObjectIDs.size());
+
+    for (uint32 ArchetypeIdx = 0; Valid && ArchetypeIdx < ArchetypeNames.size(); ArchetypeIdx++)
+        Valid = (mPropertyTemplates.find(ArchetypeNames[ArchetypeIdx]) != mPropertyTemplates.end());
+
+    for (uint32 ScriptIdx = 0; Valid && ScriptIdx < ScriptObjectIDs.size(); ScriptIdx++)
+        Valid = (mScriptTemplates.find(ScriptObjectIDs[ScriptIdx]) != mScriptTemplates.end());
+
+    uint32 NumBlocks = ArchetypeNames.size() + ScriptObjectIDs.size();
+    uint32 DataStart = Cache.Tell();
+
+    for (uint32 BlockIdx = 0; Valid && BlockIdx < NumBlocks; BlockIdx++)
+    {
+        uint32 Remaining = CacheData.size() - Cache.Tell();
+
+        if (Remaining < 4)
+        {
+            Valid = false;
+            break;
+        }
+
+        uint32 BlockSize = Cache.ReadLong();
+        Valid = (BlockSize <= Remaining - 4);
+        if (Valid) Cache.Seek(BlockSize, SEEK_CUR);
+    }
+
+    if (!Valid)
+    {
+        warnf("Template cache is corrupt, loading from XML: %s", *kCachePath);
+        mScriptTemplates.clear();
+        mPropertyTemplates.clear();
+        mStates.clear();
+        mMessages.clear();
+        return false;
+    }
+
+    Cache.Seek(DataStart, SEEK_SET);
     mFullyLoaded = true;
 
-    // Load all sub-templates
-    const TString gkGameRoot = GetGameDirectory();
+    // Hand the compiled data for each template off to its owner
+    Internal_CreateScriptTemplates();
+
+    for (uint32 ArchetypeIdx = 0; ArchetypeIdx < ArchetypeNames.size(); ArchetypeIdx++)
+    {
+        auto Iter = mPropertyTemplates.find(ArchetypeNames[ArchetypeIdx]);
+        std::vector<char>& rData = Iter->second.CachedData;
+        rData.resize(Cache.ReadLong());
+        Cache.ReadBytes(rData.data(), rData.size());
+    }
+
+    for (uint32 ScriptIdx = 0; ScriptIdx < ScriptObjectIDs.size(); ScriptIdx++)
+    {
+        CScriptTemplate* pTemplate = TemplateByID(ScriptObjectIDs[ScriptIdx]);
+        std::vector<char> Data(Cache.ReadLong());
+        Cache.ReadBytes(Data.data(), Data.size());
+        pTemplate->SetCachedData(std::move(Data), ScriptObjectNames[ScriptIdx]);
+    }
+
+    return true;
+}
+
+/** Internal function for writing the templates out to the compiled template cache.
+ *  Each template is compiled to a separate block so that it can be loaded individually.
+ */
+void CGameTemplate::Internal_SaveCache()
+{
+    const TString kGameDir = GetGameDirectory();
+    const TString kCachePath = Internal_CachePath();
+    const CSerialVersion kVersion(IArchive::skCurrentArchiveVersion, 0, mGame);
+
+    // Gather the source files that the cache depends on
+    std::vector<TString> SourceFiles;
+    SourceFiles.reserve(1 + mScriptTemplates.size() + mPropertyTemplates.size());
+    SourceFiles.push_back( mSourceFile.GetFileName() );
 
     for (auto Iter = mScriptTemplates.begin(); Iter != mScriptTemplates.end(); Iter++)
+        SourceFiles.push_back(Iter->second.Path);
+
+    for (auto Iter = mPropertyTemplates.begin(); Iter != mPropertyTemplates.end(); Iter++)
+        SourceFiles.push_back(Iter->second.Path);
+
+    NTemplateCache::SCacheHeader Header;
+
+    if (!NTemplateCache::BuildCacheHeader(kGameDir, SourceFiles, Header))
     {
-        SScriptTemplatePath& ScriptPath = Iter->second;
-        TString AbsPath = gkGameRoot + ScriptPath.Path;
-        ScriptPath.pTemplate = std::make_shared<CScriptTemplate>(this, Iter->first, AbsPath);
+        warnf("Unable to hash template source files; not writing template cache: %s", *kCachePath);
+        return;
     }
 
+    // Compile templates. Templates that haven't been loaded yet can reuse the data they were cached with.
+    std::vector<TString> ArchetypeNames;
+    std::vector<uint32> ScriptObjectIDs;
+    std::vector<TString> ScriptObjectNames;
+    std::vector< std::vector<char> > TemplateData;
+    TemplateData.reserve(mPropertyTemplates.size() + mScriptTemplates.size());
+
     for (auto Iter = mPropertyTemplates.begin(); Iter != mPropertyTemplates.end(); Iter++)
     {
-        // For properties, remember that property archetypes can reference other archetypes which
-        // may not be loaded yet.. so if this happens, the referenced property will be loaded,
-        // meaning property templates can be loaded out of order, so we need to make sure
-        // that we don't load any template more than once.
-        SPropertyTemplatePath& PropertyPath = Iter->second;
+        SPropertyTemplatePath& Path = Iter->second;
+
+        if (!Path.pTemplate && Path.CachedData.empty())
+            Internal_LoadPropertyTemplate(Path);
+
+        ArchetypeNames.push_back(Iter->first);
+        TemplateData.emplace_back();
+
+        if (Path.pTemplate)
+        {
+            CVectorOutStream DataStream(&TemplateData.back(), EEndian::BigEndian);
+            CBinaryWriter Writer(&DataStream, kVersion);
+            Writer << SerialParameter("PropertyArchetype", Path.pTemplate);
+        }
+        else
+            TemplateData.back() = Path.CachedData;
+    }
+
+    for (auto Iter = mScriptTemplates.begin(); Iter != mScriptTemplates.end(); Iter++)
+    {
+        CScriptTemplate* pTemplate = Iter->second.pTemplate.get();
+
+        if (!pTemplate->IsLoaded() && pTemplate->CachedData().empty())
+            pTemplate->Load();
+
+        ScriptObjectIDs.push_back(Iter->first);
+        ScriptObjectNames.push_back(pTemplate->Name());
+        TemplateData.emplace_back();
 
-        if (!PropertyPath.pTemplate)
+        if (pTemplate->IsLoaded())
         {
-            Internal_LoadPropertyTemplate(Iter->second);
+            CVectorOutStream DataStream(&TemplateData.back(), EEndian::BigEndian);
+            CBinaryWriter Writer(&DataStream, kVersion);
+            pTemplate->Serialize(Writer);
         }
+        else
+            TemplateData.back() = pTemplate->CachedData();
     }
+
+    // Compile the index
+    std::vector<char> IndexData;
+    {
+        CVectorOutStream IndexStream(&IndexData, EEndian::BigEndian);
+        CBinaryWriter Index(&IndexStream, kVersion);
+        Index << SerialParameter("Header", Header);
+        Serialize(Index);
+        Index << SerialParameter("CachedArchetypes", ArchetypeNames)
+              << SerialParameter("CachedScriptTemplates", ScriptObjectIDs)
+              << SerialParameter("CachedScriptTemplateNames", ScriptObjectNames);
+    }
+
+    // Write everything out to a temp file first, so an interrupted save can't leave a truncated cache behind
+    const TString kNewCachePath = kCachePath + ".tmp";
+    {
+        CFileOutStream File(kNewCachePath, EEndian::BigEndian);
+
+        if (!File.IsValid())
+        {
+            warnf("Failed to open template cache for writing: %s", *kNewCachePath);
+            return;
+        }
+
+        debugf("Saving template cache: %s", *kCachePath);
+        File.WriteLong(FOURCC('TMPC'));
+        File.WriteLong(NTemplateCache::gkCacheVersion);
+        File.WriteLong(IArchive::skCurrentArchiveVersion);
+        File.WriteLong((uint32) mGame);
+        File.WriteLong(IndexData.size());
+        File.WriteBytes(IndexData.data(), IndexData.size());
+
+        for (uint32 DataIdx = 0; DataIdx < TemplateData.size(); DataIdx++)
+        {
+            File.WriteLong(TemplateData[DataIdx].size());
+            File.WriteBytes(TemplateData[DataIdx].data(), TemplateData[DataIdx].size());
+        }
+    }
+
+    FileUtil::DeleteFile(kCachePath);
+
+    if (!FileUtil::MoveFile(kNewCachePath, kCachePath))
+        warnf("Failed to replace template cache: %s", *kCachePath);
 }
 
-void CGameTemplate::Save()
+/** Returns the path to the compiled template cache for this game */
+TString CGameTemplate::Internal_CachePath() const
 {
-    debugf("Saving game template: %s", *mSourceFile);
-    CXMLWriter Writer(mSourceFile, "Game", 0, mGame);
-    ASSERT(Writer.IsValid());
-    Serialize(Writer);
-    mDirty = false;
+    return GetGameDirectory() + "TemplateCache.bin";
 }
 
-/** Internal function for loading a property template from a file. */
-void CGameTemplate::Internal_LoadPropertyTemplate(SPropertyTemplatePath& Path)
+/** Fully load every script template and property archetype.
+ *  XML files are parsed ahead of time on the worker pool. Only the parsing happens in parallel;
+ *  deserialization stays on this thread, because property initialization and registration
+ *  with the property name map aren't thread-safe.
+ */
+void CGameTemplate::LoadAllTemplates()
 {
-    if (Path.pTemplate != nullptr) // don't load twice
-        return;
-
     const TString kGameDir = GetGameDirectory();
-    const TString kTemplateFilePath = kGameDir + Path.Path;
-    CXMLReader Reader(kTemplateFilePath);
-    ASSERT(Reader.IsValid());
+    std::vector<TString> XMLPaths;
 
-    Reader << SerialParameter("PropertyArchetype", Path.pTemplate);
-    ASSERT(Path.pTemplate != nullptr);
+    for (auto Iter = mPropertyTemplates.begin(); Iter != mPropertyTemplates.end(); Iter++)
+    {
+        const SPropertyTemplatePath& kPath = Iter->second;
 
-    Path.pTemplate->Initialize(nullptr, nullptr, 0);
+        if (!kPath.pTemplate && kPath.CachedData.empty())
+            XMLPaths.push_back(kGameDir + kPath.Path);
+    }
+
+    for (auto Iter = mScriptTemplates.begin(); Iter != mScriptTemplates.end(); Iter++)
+    {
+        CScriptTemplate* pTemplate = Iter->second.pTemplate.get();
+
+        if (!pTemplate->IsLoaded() && pTemplate->CachedData().empty())
+            XMLPaths.push_back(pTemplate->SourceFile());
+    }
+
+    std::vector< std::unique_ptr<CXMLReader> > Readers(XMLPaths.size());
+
+    CWorkerPool::Shared()->ParallelFor(XMLPaths.size(), [&XMLPaths, &Readers](uint32 PathIdx)
+    {
+        Readers[PathIdx] = std::make_unique<CXMLReader>(XMLPaths[PathIdx]);
+    });
+
+    for (uint32 PathIdx = 0; PathIdx < XMLPaths.size(); PathIdx++)
+        mPreparsedXML[XMLPaths[PathIdx]] = std::move(Readers[PathIdx]);
+
+    // Load archetypes first, so archetype references in script templates don't need to recurse
+    for (auto Iter = mPropertyTemplates.begin(); Iter != mPropertyTemplates.end(); Iter++)
+        Internal_LoadPropertyTemplate(Iter->second);
+
+    for (auto Iter = mScriptTemplates.begin(); Iter != mScriptTemplates.end(); Iter++)
+    {
+        CScriptTemplate* pTemplate = Iter->second.pTemplate.get();
+
+        if (!pTemplate->IsLoaded())
+        {
+            std::unique_ptr<CXMLReader> pReader = Internal_TakePreparsedXML(pTemplate->SourceFile());
+            pTemplate->Load(pReader.get());
+        }
+    }
+
+    mPreparsedXML.clear();
 }
 
 void CGameTemplate::SaveGameTemplates(bool ForceAll /*= false*/)
 {
     const TString kGameDir = GetGameDirectory();
+    bool SavedAny = false;
+
+    // Templates that haven't been loaded can't be dirty, but they still need to be loaded for a forced save
+    if (ForceAll)
+    {
+        LoadAllTemplates();
+    }
 
     if (mDirty || ForceAll)
     {
         Save();
+        SavedAny = true;
     }
 
     for (auto Iter = mScriptTemplates.begin(); Iter != mScriptTemplates.end(); Iter++)
@@ -94,6 +464,7 @@ void CGameTemplate::SaveGameTemplates(bool ForceAll /*= false*/)
 
         if( Path.pTemplate )
         {
+            SavedAny |= (ForceAll || Path.pTemplate->IsDirty());
             Path.pTemplate->Save(ForceAll);
         }
     }
@@ -115,9 +486,16 @@ void CGameTemplate::SaveGameTemplates(bool ForceAll /*= false*/)
 
                 Writer << SerialParameter("PropertyArchetype", Path.pTemplate);
                 Path.pTemplate->ClearDirtyFlag();
+                SavedAny = true;
             }
         }
     }
+
+    // Rebuild the template cache so it stays in sync with the resaved XMLs
+    if (SavedAny)
+    {
+        Internal_SaveCache();
+    }
 }
 
 uint32 CGameTemplate::GameVersion(TString VersionName)
@@ -223,6 +601,9 @@ bool CGameTemplate::RenamePropertyArchetype(const TString& kTypeName, const TStr
 {
     if( kTypeName != kNewTypeName )
     {
+        // All sub-instances of the archetype need to exist in order to be updated
+        LoadAllTemplates();
+
         // Fetch the property that we are going to be renaming.
         // Validate type, too, because we only support renaming struct archetypes at the moment
         auto Iter = mPropertyTemplates.find(kTypeName);
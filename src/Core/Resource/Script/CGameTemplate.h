@@ -6,7 +6,9 @@
 #include "Core/Resource/Script/Property/Properties.h"
 #include <Common/BasicTypes.h>
 #include <Common/EGame.h>
+#include <Common/Serialization/XML.h>
 #include <map>
+#include <memory>
 
 /** Serialization aid
  *  Retro switched from using integers to fourCCs to represent IDs in several cases (states/messages, object IDs).
@@ -76,6 +78,9 @@ struct SPropertyTemplatePath
     /** Template in memory */
     std::shared_ptr<IProperty> pTemplate;
 
+    /** Compiled template data from the template cache; used to load the template on first use */
+    std::vector<char> CachedData;
+
     /** Constructor */
     SPropertyTemplatePath()
     {}
@@ -107,8 +112,19 @@ class CGameTemplate
     std::map<SObjId, TString> mStates;
     std::map<SObjId, TString> mMessages;
 
-    /** Internal function for loading a property template from a file. */
+    /** Template XMLs parsed ahead of time by LoadAllTemplates, keyed by absolute file path */
+    std::map< TString, std::unique_ptr<CXMLReader> > mPreparsedXML;
+
+    /** Internal function for loading a property template, either from cached data or from its source XML. */
     void Internal_LoadPropertyTemplate(SPropertyTemplatePath& Path);
+    std::unique_ptr<CXMLReader> Internal_TakePreparsedXML(const TString& kFilePath);
+
+    /** Internal functions for loading from the source XML files and the compiled template cache. */
+    void Internal_CreateScriptTemplates();
+    void Internal_LoadFromXML();
+    bool Internal_LoadFromCache();
+    void Internal_SaveCache();
+    TString Internal_CachePath() const;
 
 public:
     CGameTemplate();
@@ -116,6 +132,7 @@ public:
     void Load(const TString& kFilePath);
     void Save();
     void SaveGameTemplates(bool ForceAll = false);
+    void LoadAllTemplates();
 
     uint32 GameVersion(TString VersionName);
     CScriptTemplate* TemplateByID(uint32 ObjectID);
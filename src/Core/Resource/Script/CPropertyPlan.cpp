@@ -0,0 +1,53 @@
+#include "CPropertyPlan.h"
+#include "Core/Resource/Script/Property/CArrayProperty.h"
+
+CPropertyPlan::CPropertyPlan(IProperty* pRootProperty)
+{
+    ASSERT(pRootProperty);
+    AddOp(pRootProperty);
+}
+
+void CPropertyPlan::AddOp(IProperty* pProperty)
+{
+    uint32 OpIndex = mOps.size();
+
+    SOp Op;
+    Op.pProperty = pProperty;
+    Op.ID = pProperty->ID();
+    Op.Type = pProperty->Type();
+    Op.CookPreference = pProperty->CookPreference();
+    Op.Atomic = pProperty->IsAtomic();
+    Op.NumChildren = 0;
+    Op.SubtreeEnd = 0;
+    mOps.push_back(Op);
+
+    // Array items are serialized using the item archetype, which is stored as the array's only child op
+    if (Op.Type == EPropertyType::Array)
+    {
+        AddOp( TPropCast<CArrayProperty>(pProperty)->ItemArchetype() );
+        mOps[OpIndex].NumChildren = 1;
+    }
+    else if (Op.Type == EPropertyType::Struct)
+    {
+        for (uint32 ChildIdx = 0; ChildIdx < pProperty->NumChildren(); ChildIdx++)
+            AddOp( pProperty->ChildByIndex(ChildIdx) );
+
+        mOps[OpIndex].NumChildren = pProperty->NumChildren();
+    }
+
+    mOps[OpIndex].SubtreeEnd = mOps.size();
+}
+
+/** Find the direct child of a struct op with the given property ID. Returns skInvalidOp if there isn't one. */
+uint32 CPropertyPlan::FindChild(uint32 StructOp, uint32 ID) const
+{
+    const SOp& rkStruct = mOps[StructOp];
+
+    for (uint32 ChildOp = FirstChild(StructOp); ChildOp < rkStruct.SubtreeEnd; ChildOp = NextSibling(ChildOp))
+    {
+        if (mOps[ChildOp].ID == ID)
+            return ChildOp;
+    }
+
+    return skInvalidOp;
+}
@@ -0,0 +1,49 @@
+#ifndef CPROPERTYPLAN_H
+#define CPROPERTYPLAN_H
+
+#include "Core/Resource/Script/Property/IProperty.h"
+#include <Common/BasicTypes.h>
+#include <vector>
+
+// Whether the script loader and cooker serialize properties using compiled property plans.
+// Disabled until a load->cook round trip has been verified to be byte-identical over MP1-DKCR SCLY data;
+// until then, properties are serialized by walking the property tree directly.
+#define USE_PROPERTY_PLANS 0
+
+/** CPropertyPlan: A script template's property tree flattened into a list of ops, for serialization.
+ *  Every instance of a template has the same layout, so the loader and cooker walk this list instead
+ *  of looking up children in the property tree for every instance. Ops are stored depth-first; the
+ *  children of a struct follow it directly, and each op records where its subtree ends.
+ */
+class CPropertyPlan
+{
+public:
+    static const uint32 skInvalidOp = (uint32) -1;
+
+    struct SOp
+    {
+        IProperty* pProperty;
+        uint32 ID;
+        EPropertyType Type;
+        ECookPreference CookPreference;
+        bool Atomic;
+        uint32 NumChildren;
+        uint32 SubtreeEnd;
+    };
+
+private:
+    std::vector<SOp> mOps;
+
+    void AddOp(IProperty* pProperty);
+
+public:
+    explicit CPropertyPlan(IProperty* pRootProperty);
+    uint32 FindChild(uint32 StructOp, uint32 ID) const;
+
+    inline uint32 NumOps() const                    { return mOps.size(); }
+    inline const SOp& Op(uint32 OpIndex) const      { return mOps[OpIndex]; }
+    inline uint32 FirstChild(uint32 OpIndex) const  { return OpIndex + 1; }
+    inline uint32 NextSibling(uint32 OpIndex) const { return mOps[OpIndex].SubtreeEnd; }
+};
+
+#endif // CPROPERTYPLAN_H
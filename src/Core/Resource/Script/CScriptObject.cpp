@@ -20,7 +20,7 @@ CScriptObject::CScriptObject(uint32 InstanceID, CGameArea *pArea, CScriptLayer *
 
     mPropertyData.resize( PropertiesSize );
     void* pData = mPropertyData.data();
-    pProperties->Construct( pData );
+    pTemplate->ConstructPropertyData( pData );
 
     mInstanceName = CStringRef(pData, pTemplate->NameProperty());
     mPosition = CVectorRef(pData, pTemplate->PositionProperty());
@@ -4,6 +4,7 @@
 #include "Core/GameProject/CResourceStore.h"
 #include "Core/Resource/Animation/CAnimSet.h"
 #include <Common/Log.h>
+#include <Common/Serialization/Binary.h>
 
 #include <iostream>
 #include <string>
@@ -23,6 +24,8 @@ CScriptTemplate::CScriptTemplate(CGameTemplate *pGame)
     , mPreviewScale(1.f)
     , mVolumeShape(EVolumeShape::NoShape)
     , mVolumeScale(1.f)
+    , mLoaded(true)
+    , mHasDefaultPropertyData(false)
 {
 }
 
@@ -44,26 +47,14 @@ CScriptTemplate::CScriptTemplate(CGameTemplate* pInGame, uint32 InObjectID, cons
     , mpLightParametersProperty(nullptr)
     , mVisible(true)
     , mDirty(false)
+    , mLoaded(false)
+    , mHasDefaultPropertyData(false)
 {
-    // Load
-    CXMLReader Reader(kInFilePath);
-    ASSERT(Reader.IsValid());
-    Serialize(Reader);
-
-    // Post load initialization
-    mSourceFile = kInFilePath;
-    mpProperties->Initialize(nullptr, this, 0);
-
-    if (!mNameIDString.IsEmpty())               mpNameProperty = TPropCast<CStringProperty>( mpProperties->ChildByIDString(mNameIDString) );
-    if (!mPositionIDString.IsEmpty())           mpPositionProperty = TPropCast<CVectorProperty>( mpProperties->ChildByIDString(mPositionIDString) );
-    if (!mRotationIDString.IsEmpty())           mpRotationProperty = TPropCast<CVectorProperty>( mpProperties->ChildByIDString(mRotationIDString) );
-    if (!mScaleIDString.IsEmpty())              mpScaleProperty = TPropCast<CVectorProperty>( mpProperties->ChildByIDString(mScaleIDString) );
-    if (!mActiveIDString.IsEmpty())             mpActiveProperty = TPropCast<CBoolProperty>( mpProperties->ChildByIDString(mActiveIDString) );
-    if (!mLightParametersIDString.IsEmpty())    mpLightParametersProperty = TPropCast<CStructProperty>( mpProperties->ChildByIDString(mLightParametersIDString) );
 }
 
 CScriptTemplate::~CScriptTemplate()
 {
+    InvalidateDefaultPropertyData();
 }
 
 void CScriptTemplate::Serialize(IArchive& Arc)
@@ -94,8 +85,49 @@ void CScriptTemplate::Serialize(IArchive& Arc)
         << SerialParameter("VolumeConditions", mVolumeConditions, SH_Optional);
 }
 
+void CScriptTemplate::Load(IArchive* pArchive /*= nullptr*/)
+{
+    ASSERT(!mLoaded);
+    mLoaded = true;
+
+    // Load from the provided archive if there is one, then compiled cache data, then the source XML.
+    if (pArchive)
+    {
+        Serialize(*pArchive);
+    }
+    else if (!mCachedData.empty())
+    {
+        CMemoryInStream DataStream(mCachedData.data(), mCachedData.size(), EEndian::BigEndian);
+        CBinaryReader Reader(&DataStream, CSerialVersion(IArchive::skCurrentArchiveVersion, 0, Game()));
+        Serialize(Reader);
+    }
+    else
+    {
+        CXMLReader Reader(mSourceFile);
+        ASSERT(Reader.IsValid());
+        Serialize(Reader);
+    }
+
+    // The cached data is stale as soon as the template is loaded and can be edited
+    std::vector<char>().swap(mCachedData);
+
+    // Post load initialization
+    mpProperties->Initialize(nullptr, this, 0);
+
+    if (!mNameIDString.IsEmpty())               mpNameProperty = TPropCast<CStringProperty>( mpProperties->ChildByIDString(mNameIDString) );
+    if (!mPositionIDString.IsEmpty())           mpPositionProperty = TPropCast<CVectorProperty>( mpProperties->ChildByIDString(mPositionIDString) );
+    if (!mRotationIDString.IsEmpty())           mpRotationProperty = TPropCast<CVectorProperty>( mpProperties->ChildByIDString(mRotationIDString) );
+    if (!mScaleIDString.IsEmpty())              mpScaleProperty = TPropCast<CVectorProperty>( mpProperties->ChildByIDString(mScaleIDString) );
+    if (!mActiveIDString.IsEmpty())             mpActiveProperty = TPropCast<CBoolProperty>( mpProperties->ChildByIDString(mActiveIDString) );
+    if (!mLightParametersIDString.IsEmpty())    mpLightParametersProperty = TPropCast<CStructProperty>( mpProperties->ChildByIDString(mLightParametersIDString) );
+}
+
 void CScriptTemplate::Save(bool Force)
 {
+    // Templates that were never loaded can't have been modified
+    if (Force)
+        ConditionalLoad();
+
     if (IsDirty() || Force)
     {
         debugf("Saving script template: %s", *mSourceFile);
@@ -106,6 +138,94 @@ void CScriptTemplate::Save(bool Force)
     }
 }
 
+/** Returns the template's property plan, compiling it if it hasn't been built yet */
+const CPropertyPlan* CScriptTemplate::PropertyPlan()
+{
+    ConditionalLoad();
+
+    if (!mpPropertyPlan)
+        mpPropertyPlan = std::make_unique<CPropertyPlan>(mpProperties.get());
+
+    return mpPropertyPlan.get();
+}
+
+/** Discard the property plan. Must be called whenever the property layout changes. */
+void CScriptTemplate::InvalidatePropertyPlan()
+{
+    mpPropertyPlan.reset();
+}
+
+/** Initialize a new instance's property data to the default values */
+void CScriptTemplate::ConstructPropertyData(void* pData)
+{
+    ConditionalLoad();
+
+    if (!mHasDefaultPropertyData)
+        BuildDefaultPropertyData();
+
+    // Copy the default block, then construct the properties that don't support bytewise copies
+    // over the top of their copied bytes. Their copied bytes are never destructed, so this is safe.
+    if (!mDefaultPropertyData.empty())
+        memcpy(pData, mDefaultPropertyData.data(), mDefaultPropertyData.size());
+
+    for (uint32 PropIdx = 0; PropIdx < mNonTrivialProperties.size(); PropIdx++)
+        mNonTrivialProperties[PropIdx]->Construct(pData);
+}
+
+/** Discard the default property data. Must be called before the property layout changes. */
+void CScriptTemplate::InvalidateDefaultPropertyData()
+{
+    if (mHasDefaultPropertyData)
+    {
+        mpProperties->Destruct(mDefaultPropertyData.data());
+        mDefaultPropertyData.clear();
+        mNonTrivialProperties.clear();
+        mHasDefaultPropertyData = false;
+    }
+}
+
+void CScriptTemplate::BuildDefaultPropertyData()
+{
+    mDefaultPropertyData.resize( mpProperties->DataSize() );
+    mpProperties->Construct( mDefaultPropertyData.data() );
+    GatherNonTrivialProperties( mpProperties.get() );
+    mHasDefaultPropertyData = true;
+}
+
+void CScriptTemplate::GatherNonTrivialProperties(IProperty* pProperty)
+{
+    // Struct values are made up entirely of their children. Array items live in separately allocated
+    // storage, so the array itself is the property that needs constructing, not its item archetype.
+    if (pProperty->Type() == EPropertyType::Struct)
+    {
+        for (uint32 ChildIdx = 0; ChildIdx < pProperty->NumChildren(); ChildIdx++)
+            GatherNonTrivialProperties( pProperty->ChildByIndex(ChildIdx) );
+    }
+    else if (!pProperty->IsTriviallyCopyable())
+    {
+        mNonTrivialProperties.push_back(pProperty);
+    }
+}
+
+TString CScriptTemplate::Name()
+{
+    // Unloaded templates use the name recorded in the template cache, so template lists don't force a load
+    if (!mLoaded && !mCachedName.IsEmpty())
+        return mCachedName;
+
+    ConditionalLoad();
+    return mpProperties->Name();
+}
+
+void CScriptTemplate::SetCachedData(std::vector<char>&& rData, const TString& kName)
+{
+    ASSERT(!mLoaded);
+    mCachedData = std::move(rData);
+
+    // The name is cached separately so that template lists can be displayed and sorted without loading every template
+    mCachedName = kName;
+}
+
 EGame CScriptTemplate::Game() const
 {
     return mpGame->Game();
@@ -323,11 +443,3 @@ void CScriptTemplate::RemoveObject(CScriptObject *pObject)
         }
     }
 }
-
-void CScriptTemplate::SortObjects()
-{
-    // todo: make this function take layer names into account
-    mObjectList.sort([](CScriptObject *pA, CScriptObject *pB) -> bool {
-        return (pA->InstanceID() < pB->InstanceID());
-    });
-}
@@ -2,6 +2,7 @@
 #define CSCRIPTTEMPLATE_H
 
 #include "Core/Resource/Script/Property/Properties.h"
+#include "CPropertyPlan.h"
 #include "EVolumeShape.h"
 #include "Core/Resource/Model/CModel.h"
 #include "Core/Resource/CCollisionMeshGroup.h"
@@ -126,17 +127,38 @@ private:
     bool mVisible;
     bool mDirty;
 
+    // Lazy loading. Templates are only loaded the first time they're needed; until then,
+    // the template may hold compiled data from the template cache to load from.
+    bool mLoaded;
+    std::vector<char> mCachedData;
+    TString mCachedName;
+
+    // Flattened property layout used to serialize instances; built the first time it's needed
+    std::unique_ptr<CPropertyPlan> mpPropertyPlan;
+
+    // Fully constructed default property values, used to initialize new instances with a single copy.
+    // Properties whose values can't be copied bytewise (such as strings) are constructed separately.
+    bool mHasDefaultPropertyData;
+    std::vector<char> mDefaultPropertyData;
+    std::vector<IProperty*> mNonTrivialProperties;
+
 public:
     // Default constructor. Don't use. This is only here so the serializer doesn't complain
     CScriptTemplate() { ASSERT(false); }
     // Old constructor
     CScriptTemplate(CGameTemplate *pGame);
-    // New constructor
+    // New constructor. The template isn't loaded until it's first accessed; see Load().
     CScriptTemplate(CGameTemplate* pGame, uint32 ObjectID, const TString& kFilePath);
     ~CScriptTemplate();
     void Serialize(IArchive& rArc);
+    void Load(IArchive* pArchive = nullptr);
     void Save(bool Force = false);
+    void SetCachedData(std::vector<char>&& rData, const TString& kName);
     EGame Game() const;
+    const CPropertyPlan* PropertyPlan();
+    void InvalidatePropertyPlan();
+    void ConstructPropertyData(void* pData);
+    void InvalidateDefaultPropertyData();
 
     // Property Fetching
     EVolumeShape VolumeShape(CScriptObject *pObj);
@@ -146,38 +168,42 @@ public:
 
     // Accessors
     inline CGameTemplate* GameTemplate() const              { return mpGame; }
-    inline TString Name() const                             { return mpProperties->Name(); }
-    inline ERotationType RotationType() const               { return mRotationType; }
-    inline EScaleType ScaleType() const                     { return mScaleType; }
-    inline float PreviewScale() const                       { return mPreviewScale; }
+    TString Name();
+    inline ERotationType RotationType()                     { ConditionalLoad(); return mRotationType; }
+    inline EScaleType ScaleType()                           { ConditionalLoad(); return mScaleType; }
+    inline float PreviewScale()                             { ConditionalLoad(); return mPreviewScale; }
     inline uint32 ObjectID() const                          { return mObjectID; }
     inline bool IsVisible() const                           { return mVisible; }
+    inline bool IsLoaded() const                            { return mLoaded; }
     inline TString SourceFile() const                       { return mSourceFile; }
-    inline CStructProperty* Properties() const              { return mpProperties.get(); }
-    inline uint32 NumAttachments() const                    { return mAttachments.size(); }
-    const SAttachment& Attachment(uint32 Index) const       { return mAttachments[Index]; }
-    const std::vector<TString>& RequiredModules() const     { return mModules; }
-
-    inline CStringProperty* NameProperty() const                { return mpNameProperty; }
-    inline CVectorProperty* PositionProperty() const            { return mpPositionProperty; }
-    inline CVectorProperty* RotationProperty() const            { return mpRotationProperty; }
-    inline CVectorProperty* ScaleProperty() const               { return mpScaleProperty; }
-    inline CBoolProperty* ActiveProperty() const                { return mpActiveProperty; }
-    inline CStructProperty* LightParametersProperty() const     { return mpLightParametersProperty; }
+    inline CStructProperty* Properties()                    { ConditionalLoad(); return mpProperties.get(); }
+    inline uint32 NumAttachments()                          { ConditionalLoad(); return mAttachments.size(); }
+    const SAttachment& Attachment(uint32 Index)             { ConditionalLoad(); return mAttachments[Index]; }
+    const std::vector<TString>& RequiredModules()           { ConditionalLoad(); return mModules; }
+    const std::vector<char>& CachedData() const             { return mCachedData; }
+
+    inline CStringProperty* NameProperty()                  { ConditionalLoad(); return mpNameProperty; }
+    inline CVectorProperty* PositionProperty()              { ConditionalLoad(); return mpPositionProperty; }
+    inline CVectorProperty* RotationProperty()              { ConditionalLoad(); return mpRotationProperty; }
+    inline CVectorProperty* ScaleProperty()                 { ConditionalLoad(); return mpScaleProperty; }
+    inline CBoolProperty* ActiveProperty()                  { ConditionalLoad(); return mpActiveProperty; }
+    inline CStructProperty* LightParametersProperty()       { ConditionalLoad(); return mpLightParametersProperty; }
 
     inline void SetVisible(bool Visible)    { mVisible = Visible; }
     inline void MarkDirty()                 { mDirty = true; }
-    inline bool IsDirty() const             { return mDirty || mpProperties->IsDirty(); }
+    inline bool IsDirty() const             { return mLoaded && (mDirty || mpProperties->IsDirty()); }
+    inline void ConditionalLoad()           { if (!mLoaded) Load(); }
 
     // Object Tracking
     uint32 NumObjects() const;
     const std::list<CScriptObject*>& ObjectList() const;
     void AddObject(CScriptObject *pObject);
     void RemoveObject(CScriptObject *pObject);
-    void SortObjects();
 
 private:
     int32 CheckVolumeConditions(CScriptObject *pObj, bool LogErrors);
+    void BuildDefaultPropertyData();
+    void GatherNonTrivialProperties(IProperty* pProperty);
 };
 
 #endif // CSCRIPTTEMPLATE_H
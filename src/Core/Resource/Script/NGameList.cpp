@@ -107,11 +107,16 @@ void SaveGameList()
     SerializeGameList(Writer);
 }
 
-/** Load all game templates into memory */
+/** Load all game templates into memory, including all of their script and property templates */
 void LoadAllGameTemplates()
 {
     for (int GameIdx = 0; GameIdx < (int) EGame::Max; GameIdx++)
-        GetGameTemplate( (EGame) GameIdx );
+    {
+        CGameTemplate* pGame = GetGameTemplate( (EGame) GameIdx );
+
+        if (pGame)
+            pGame->LoadAllTemplates();
+    }
 }
 
 /** Resave templates. If ForceAll is false, only saves templates that have been modified. */
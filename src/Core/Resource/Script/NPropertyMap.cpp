@@ -1,6 +1,9 @@
 #include "NPropertyMap.h"
 #include "NGameList.h"
+#include "NTemplateCache.h"
+#include <Common/FileUtil.h>
 #include <Common/NBasics.h>
+#include <Common/Serialization/Binary.h>
 #include <Common/Serialization/XML.h>
 
 /** NPropertyMap: Namespace for property ID -> name mappings */
@@ -11,6 +14,11 @@ namespace NPropertyMap
 const char* gpkLegacyMapPath = "../templates/PropertyMapLegacy.xml";
 const char* gpkMapPath = "../templates/PropertyMap.xml";
 
+/** Path to the compiled property map cache, and the directory/file name used to validate it */
+const char* gpkMapCachePath = "../templates/PropertyMapCache.bin";
+const char* gpkMapCacheBaseDir = "../templates/";
+const char* gpkMapCacheSourceFile = "PropertyMap.xml";
+
 /** Whether to do name lookups from the legacy map */
 const bool gkUseLegacyMapForNameLookups = false;
 
@@ -141,6 +149,60 @@ SNameKey CreateKey(uint32 ID, const char* pkTypeName)
     return SNameKey( CCRC32::StaticHashString(pkTypeName), ID );
 }
 
+/** Internal: Loads the name map from the compiled cache. Returns false if the cache is missing or out of date. */
+bool LoadMapCache()
+{
+    if (!FileUtil::Exists(gpkMapCachePath))
+        return false;
+
+    CBinaryReader Reader(gpkMapCachePath, FOURCC('PMPC'));
+
+    if (!Reader.IsValid())
+        return false;
+
+    NTemplateCache::SCacheHeader Header;
+    Reader << SerialParameter("Header", Header);
+
+    if (!NTemplateCache::IsCacheUpToDate(gpkMapCacheBaseDir, Header))
+    {
+        debugf("Property map cache is out of date, loading from XML");
+        return false;
+    }
+
+    Reader << SerialParameter("PropertyMap", gNameMap);
+    return true;
+}
+
+/** Internal: Writes the name map out to the compiled cache. */
+void SaveMapCache()
+{
+    NTemplateCache::SCacheHeader Header;
+    std::vector<TString> SourceFiles(1, gpkMapCacheSourceFile);
+
+    if (!NTemplateCache::BuildCacheHeader(gpkMapCacheBaseDir, SourceFiles, Header))
+        return;
+
+    // Write to a temp file first, so an interrupted save can't leave a truncated cache behind
+    const TString kNewCachePath = TString(gpkMapCachePath) + ".tmp";
+    {
+        CBinaryWriter Writer(kNewCachePath, FOURCC('PMPC'), 0, EGame::Invalid);
+
+        if (!Writer.IsValid())
+        {
+            warnf("Failed to open property map cache for writing: %s", *kNewCachePath);
+            return;
+        }
+
+        Writer << SerialParameter("Header", Header)
+               << SerialParameter("PropertyMap", gNameMap);
+    }
+
+    FileUtil::DeleteFile(gpkMapCachePath);
+
+    if (!FileUtil::MoveFile(kNewCachePath, gpkMapCachePath))
+        warnf("Failed to replace property map cache: %s", gpkMapCachePath);
+}
+
 /** Loads property names into memory */
 void LoadMap()
 {
@@ -155,9 +217,16 @@ void LoadMap()
     }
     else
     {
-        CXMLReader Reader(gpkMapPath);
-        ASSERT(Reader.IsValid());
-        Reader << SerialParameter("PropertyMap", gNameMap, SH_HexDisplay);
+        // Prefer the compiled cache; if it's stale, parse the XML and rebuild the cache.
+        if (!LoadMapCache())
+        {
+            gNameMap.clear();
+
+            CXMLReader Reader(gpkMapPath);
+            ASSERT(Reader.IsValid());
+            Reader << SerialParameter("PropertyMap", gNameMap, SH_HexDisplay);
+            SaveMapCache();
+        }
 
         // Iterate over the map and set up the valid flags
         for (auto Iter = gNameMap.begin(); Iter != gNameMap.end(); Iter++)
@@ -218,9 +287,14 @@ void SaveMap(bool Force /*= false*/)
             }
 
             // Perform the actual save
-            CXMLWriter Writer(gpkMapPath, "PropertyMap");
-            ASSERT(Writer.IsValid());
-            Writer << SerialParameter("PropertyMap", gNameMap, SH_HexDisplay);
+            {
+                CXMLWriter Writer(gpkMapPath, "PropertyMap");
+                ASSERT(Writer.IsValid());
+                Writer << SerialParameter("PropertyMap", gNameMap, SH_HexDisplay);
+            }
+
+            // Rebuild the cache now that the XML has been closed out
+            SaveMapCache();
         }
         gMapIsDirty = false;
     }
@@ -0,0 +1,76 @@
+#include "NTemplateCache.h"
+#include <Common/FileIO.h>
+#include <Common/FileUtil.h>
+#include <Common/Log.h>
+#include <Common/Hash/CFNV1A.h>
+
+namespace NTemplateCache
+{
+
+/** Calculate the content hash of a source file. Returns 0 if the file can't be read. */
+uint64 HashSourceFile(const TString& kFilePath)
+{
+    CFileInStream File(kFilePath, EEndian::BigEndian);
+
+    if (!File.IsValid())
+        return 0;
+
+    std::vector<uint8> FileData(File.Size());
+    File.ReadBytes(FileData.data(), FileData.size());
+
+    CFNV1A Hash(CFNV1A::k64Bit);
+    Hash.HashLong(FileData.size());
+    Hash.HashData(FileData.data(), FileData.size());
+    return Hash.GetHash64();
+}
+
+/** Fill in a cache header for a list of source files. Returns false if any file can't be read. */
+bool BuildCacheHeader(const TString& kBaseDir, const std::vector<TString>& kSourceFiles, SCacheHeader& rOutHeader)
+{
+    rOutHeader.Version = gkCacheVersion;
+    rOutHeader.SourceFiles.resize(kSourceFiles.size());
+
+    for (uint32 FileIdx = 0; FileIdx < kSourceFiles.size(); FileIdx++)
+    {
+        SSourceFile& rFile = rOutHeader.SourceFiles[FileIdx];
+        const TString kFilePath = kBaseDir + kSourceFiles[FileIdx];
+
+        rFile.Path = kSourceFiles[FileIdx];
+        rFile.Size = FileUtil::FileSize(kFilePath);
+        rFile.ModifiedTime = FileUtil::LastModifiedTime(kFilePath);
+        rFile.Hash = HashSourceFile(kFilePath);
+
+        if (rFile.Hash == 0)
+            return false;
+    }
+
+    return true;
+}
+
+/** Returns whether the cache described by the header is up to date with its source files.
+ *  Only files whose size or modification time changed since the cache was written are re-hashed. */
+bool IsCacheUpToDate(const TString& kBaseDir, const SCacheHeader& kHeader)
+{
+    if (kHeader.Version != gkCacheVersion || kHeader.SourceFiles.empty())
+        return false;
+
+    for (uint32 FileIdx = 0; FileIdx < kHeader.SourceFiles.size(); FileIdx++)
+    {
+        const SSourceFile& kFile = kHeader.SourceFiles[FileIdx];
+        const TString kFilePath = kBaseDir + kFile.Path;
+
+        if (!FileUtil::Exists(kFilePath))
+            return false;
+
+        if (FileUtil::FileSize(kFilePath) == kFile.Size && FileUtil::LastModifiedTime(kFilePath) == kFile.ModifiedTime)
+            continue;
+
+        // The file was touched; it's only out of date if the contents actually changed
+        if (HashSourceFile(kFilePath) != kFile.Hash)
+            return false;
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,82 @@
+#ifndef NTEMPLATECACHE_H
+#define NTEMPLATECACHE_H
+
+#include <Common/BasicTypes.h>
+#include <Common/TString.h>
+#include <Common/Serialization/IArchive.h>
+#include <vector>
+
+/** NTemplateCache: Helpers for the compiled binary template caches.
+ *  Game templates and the property map are parsed from XML, which is slow with the number of
+ *  templates we have. After a successful XML load, the loaded data is written back out to a binary
+ *  archive next to the source files. On the next run the binary archive is loaded instead, as long
+ *  as its source XMLs haven't changed since it was written.
+ */
+namespace NTemplateCache
+{
+
+/** Cache format version; bump this whenever template serialization changes to invalidate existing caches */
+const uint32 gkCacheVersion = 3;
+
+/** A source file the cache was built from */
+struct SSourceFile
+{
+    /** Path relative to the cache's base directory */
+    TString Path;
+
+    /** File size and modification time when the cache was written. If these still match,
+     *  the file is assumed to be unchanged; otherwise its contents are hashed and compared. */
+    uint64 Size;
+    uint64 ModifiedTime;
+
+    /** Content hash of the file */
+    uint64 Hash;
+
+    SSourceFile()
+        : Size(0)
+        , ModifiedTime(0)
+        , Hash(0)
+    {}
+
+    void Serialize(IArchive& Arc)
+    {
+        Arc << SerialParameter("Path", Path)
+            << SerialParameter("Size", Size)
+            << SerialParameter("ModifiedTime", ModifiedTime)
+            << SerialParameter("Hash", Hash);
+    }
+};
+
+/** Header stored at the start of every cache file */
+struct SCacheHeader
+{
+    /** Cache format version the file was written with */
+    uint32 Version;
+
+    /** Source files the cache was built from */
+    std::vector<SSourceFile> SourceFiles;
+
+    SCacheHeader()
+        : Version(gkCacheVersion)
+    {}
+
+    void Serialize(IArchive& Arc)
+    {
+        Arc << SerialParameter("CacheVersion", Version)
+            << SerialParameter("SourceFiles", SourceFiles);
+    }
+};
+
+/** Calculate the content hash of a source file. Returns 0 if the file can't be read. */
+uint64 HashSourceFile(const TString& kFilePath);
+
+/** Fill in a cache header for a list of source files. Returns false if any file can't be read. */
+bool BuildCacheHeader(const TString& kBaseDir, const std::vector<TString>& kSourceFiles, SCacheHeader& rOutHeader);
+
+/** Returns whether the cache described by the header is up to date with its source files.
+ *  Only files whose size or modification time changed since the cache was written are re-hashed. */
+bool IsCacheUpToDate(const TString& kBaseDir, const SCacheHeader& kHeader);
+
+}
+
+#endif // NTEMPLATECACHE_H
@@ -71,6 +71,12 @@ public:
         TTypedProperty::Destruct(pData);
     }
 
+    virtual bool IsTriviallyCopyable() const
+    {
+        // Storage is an SScriptArray, not the uint32 count this class is typed as
+        return false;
+    }
+
     virtual bool MatchesDefault(void* pData) const
     {
         return ArrayCount(pData) == 0;
@@ -9,6 +9,21 @@
 #include "Core/Resource/Script/CScriptTemplate.h"
 #include "Core/Resource/Script/NGameList.h"
 #include "Core/Resource/Script/NPropertyMap.h"
+#include <algorithm>
+#include <atomic>
+
+/** Properties with fewer children than this are searched linearly, which is faster for small structs */
+static const uint32 gkMinIndexedChildren = 8;
+
+#if PROPERTY_LOOKUP_STATS
+/** Child lookup statistics */
+static std::atomic<uint64> gNumChildLookups(0);
+static std::atomic<uint64> gNumIndexedChildLookups(0);
+static std::atomic<uint64> gNumChildLookupComparisons(0);
+#define RECORD_LOOKUP_STAT(Counter, Amount) Counter.fetch_add(Amount, std::memory_order_relaxed)
+#else
+#define RECORD_LOOKUP_STAT(Counter, Amount) ((void) (Amount))
+#endif
 
 /** IProperty */
 IProperty::IProperty(EGame Game)
@@ -38,6 +53,23 @@ void IProperty::_ClearChildren()
     }
 
     mChildren.clear();
+    mChildIDIndex.clear();
+}
+
+void IProperty::_BuildChildIDIndex()
+{
+    mChildIDIndex.clear();
+
+    if (mChildren.size() < gkMinIndexedChildren)
+        return;
+
+    mChildIDIndex.reserve(mChildren.size());
+
+    for (uint32 ChildIdx = 0; ChildIdx < mChildren.size(); ChildIdx++)
+        mChildIDIndex.push_back( std::make_pair(mChildren[ChildIdx]->mID, ChildIdx) );
+
+    // Sorting the pairs keeps duplicate IDs in child order, so lookups still return the first match
+    std::sort(mChildIDIndex.begin(), mChildIDIndex.end());
 }
 
 IProperty::~IProperty()
@@ -219,6 +251,9 @@ void IProperty::Initialize(IProperty* pInParent, CScriptTemplate* pInTemplate, u
         }
     }
 
+    // Children are final at this point, so we can index them
+    _BuildChildIDIndex();
+
     mFlags |= EPropertyFlag::IsInitialized;
 }
 
@@ -233,12 +268,40 @@ void* IProperty::RawValuePtr(void* pData) const
 
 IProperty* IProperty::ChildByID(uint32 ID) const
 {
+    RECORD_LOOKUP_STAT(gNumChildLookups, 1);
+
+    // Use the index if it's up to date. Children added after initialization (such as intrinsic
+    // children) aren't indexed, in which case we fall back to a linear search.
+    if (!mChildIDIndex.empty() && mChildIDIndex.size() == mChildren.size())
+    {
+        uint64 NumComparisons = 0;
+
+        auto Iter = std::lower_bound(mChildIDIndex.begin(), mChildIDIndex.end(), ID,
+            [&NumComparisons](const std::pair<uint32, uint32>& rkEntry, uint32 InID)
+            {
+                NumComparisons++;
+                return rkEntry.first < InID;
+            });
+
+        RECORD_LOOKUP_STAT(gNumIndexedChildLookups, 1);
+        RECORD_LOOKUP_STAT(gNumChildLookupComparisons, NumComparisons);
+
+        if (Iter != mChildIDIndex.end() && Iter->first == ID)
+            return mChildren[Iter->second];
+        else
+            return nullptr;
+    }
+
     for (uint32 ChildIdx = 0; ChildIdx < mChildren.size(); ChildIdx++)
     {
         if (mChildren[ChildIdx]->mID == ID)
+        {
+            RECORD_LOOKUP_STAT(gNumChildLookupComparisons, ChildIdx + 1);
             return mChildren[ChildIdx];
+        }
     }
 
+    RECORD_LOOKUP_STAT(gNumChildLookupComparisons, mChildren.size());
     return nullptr;
 }
 
@@ -274,6 +337,24 @@ IProperty* IProperty::ChildByIDString(const TIDString& rkIdString)
     }
 }
 
+#if PROPERTY_LOOKUP_STATS
+IProperty::SChildLookupStats IProperty::ChildLookupStats()
+{
+    SChildLookupStats Stats;
+    Stats.NumLookups = gNumChildLookups.load(std::memory_order_relaxed);
+    Stats.NumIndexedLookups = gNumIndexedChildLookups.load(std::memory_order_relaxed);
+    Stats.NumComparisons = gNumChildLookupComparisons.load(std::memory_order_relaxed);
+    return Stats;
+}
+
+void IProperty::ResetChildLookupStats()
+{
+    gNumChildLookups = 0;
+    gNumIndexedChildLookups = 0;
+    gNumChildLookupComparisons = 0;
+}
+#endif
+
 void IProperty::GatherAllSubInstances(std::list<IProperty*>& OutList, bool Recursive)
 {
     OutList.push_back(this);
@@ -399,8 +480,20 @@ bool IProperty::ConvertType(EPropertyType NewType, IProperty* pNewArchetype /*=
         return mpArchetype->ConvertType(NewType, nullptr);
     }
 
+    // Templates are loaded on demand, so make sure every sub-instance actually exists before cascading down.
+    if (IsRootArchetype())
+    {
+        NGameList::GetGameTemplate(Game())->LoadAllTemplates();
+    }
+
     IProperty* pNewProperty = Create(NewType, Game());
 
+    // The template's default property data was constructed with the old property type, so get rid of it first.
+    if (mpScriptTemplate)
+    {
+        mpScriptTemplate->InvalidateDefaultPropertyData();
+    }
+
     // We can only replace properties with types that have the same size and alignment
     if( pNewProperty->DataSize() != DataSize() || pNewProperty->DataAlignment() != DataAlignment() )
     {
@@ -491,6 +584,11 @@ bool IProperty::ConvertType(EPropertyType NewType, IProperty* pNewArchetype /*=
     pNewProperty->Initialize( mpParent, mpScriptTemplate, mOffset );
     pNewProperty->MarkDirty();
 
+    if (mpScriptTemplate)
+    {
+        mpScriptTemplate->InvalidatePropertyPlan();
+    }
+
     // Finally, if we are done converting this property and all its instances, resave the templates.
     if (IsRootArchetype())
     {
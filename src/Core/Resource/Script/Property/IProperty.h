@@ -8,6 +8,10 @@
 #include <Common/Math/MathUtil.h>
 
 #include <memory>
+#include <type_traits>
+
+// Whether property child ID lookups are counted, for profiling. Counting adds atomic operations to every lookup.
+#define PROPERTY_LOOKUP_STATS 0
 
 /** Forward declares */
 class CGameTemplate;
@@ -133,6 +137,10 @@ protected:
     /** Child properties; these appear underneath this property on the UI */
     std::vector<IProperty*> mChildren;
 
+    /** Child IDs paired with child indices, sorted by ID, for fast lookups in large structs.
+     *  Built once the property is initialized; left empty for properties with few children. */
+    std::vector< std::pair<uint32, uint32> > mChildIDIndex;
+
     /** Game this property belongs to */
     EGame mGame;
 
@@ -161,8 +169,19 @@ protected:
     /** Private constructor - use static methods to instantiate */
     IProperty(EGame Game);
     void _ClearChildren();
+    void _BuildChildIDIndex();
 
 public:
+#if PROPERTY_LOOKUP_STATS
+    /** Child ID lookup statistics, for profiling */
+    struct SChildLookupStats
+    {
+        uint64 NumLookups;
+        uint64 NumIndexedLookups;
+        uint64 NumComparisons;
+    };
+#endif
+
     virtual ~IProperty();
 
     /** Interface */
@@ -180,6 +199,7 @@ public:
     virtual void CopyDefaultValueTo(IProperty* pOtherProperty)  {}
     virtual bool IsNumericalType() const                    { return false; }
     virtual bool IsPointerType() const                      { return false; }
+    virtual bool IsTriviallyCopyable() const                { return false; }
     virtual TString ValueAsString(void* pData) const        { return ""; }
     virtual const char* HashableTypeName() const;
     virtual void* GetChildDataPointer(void* pPropertyData) const;
@@ -192,6 +212,10 @@ public:
     void* RawValuePtr(void* pData) const;
     IProperty* ChildByID(uint32 ID) const;
     IProperty* ChildByIDString(const TIDString& rkIdString);
+#if PROPERTY_LOOKUP_STATS
+    static SChildLookupStats ChildLookupStats();
+    static void ResetChildLookupStats();
+#endif
     void GatherAllSubInstances(std::list<IProperty*>& OutList, bool Recursive);
     TString GetTemplateFileName();
     bool ShouldCook(void* pPropertyData) const;
@@ -369,6 +393,12 @@ public:
     virtual void RevertToDefault(void* pData) const { ValueRef(pData) = mDefaultValue; }
 
     virtual bool CanHaveDefault() const { return true; }
+    virtual bool IsTriviallyCopyable() const
+    {
+        // Properties whose storage isn't a PropType must override this, or their values will be memcpy'd
+        ASSERT(DataSize() == sizeof(PropType));
+        return std::is_trivially_copyable<PropType>::value;
+    }
 
     virtual void InitFromArchetype(IProperty* pOther)
     {
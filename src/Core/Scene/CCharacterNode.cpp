@@ -1,11 +1,18 @@
 #include "CCharacterNode.h"
 #include "Core/Render/CRenderer.h"
 #include <Common/CTimer.h>
+#include <Common/Math/MathUtil.h>
+#include <cmath>
+
+const float CCharacterNode::skPoseBucketsPerSecond = 30.f;
+const uint32 CCharacterNode::skMaxCachedPoseBounds = 4096;
 
 CCharacterNode::CCharacterNode(CScene *pScene, uint32 NodeID, CAnimSet *pChar /*= 0*/, CSceneNode *pParent /*= 0*/)
     : CSceneNode(pScene, NodeID, pParent)
     , mAnimated(true)
     , mAnimTime(0.f)
+    , mpPosedAnim(nullptr)
+    , mPosedTimeBucket(-1)
 {
     SetCharSet(pChar);
 }
@@ -26,9 +33,18 @@ void CCharacterNode::PostLoad()
 
 void CCharacterNode::AddToRenderer(CRenderer *pRenderer, const SViewInfo& rkViewInfo)
 {
-    // todo: frustum check. Currently don't have a means of pulling the AABox for the
-    // current animation so this isn't in yet.
     if (!mpCharacter) return;
+
+    // Keep the bounds in sync with the current pose so the frustum check is accurate
+    CAABox PoseBox = PosedAABox();
+
+    if (PoseBox != mLocalAABox)
+    {
+        mLocalAABox = PoseBox;
+        MarkTransformChanged();
+    }
+
+    if (!rkViewInfo.ViewFrustum.BoxInFrustum(AABox())) return;
     UpdateTransformData();
 
     CModel *pModel = mpCharacter->Character(mActiveCharSet)->pModel;
@@ -80,7 +96,7 @@ void CCharacterNode::Draw(FRenderOptions Options, int ComponentIndex, ERenderCom
 
 SRayIntersection CCharacterNode::RayNodeIntersectTest(const CRay& rkRay, uint32 /*AssetID*/, const SViewInfo& rkViewInfo)
 {
-    // Check for bone under ray. Doesn't check for model intersections atm
+    // Check for bone under ray. Bones are drawn in front of the mesh, so they take priority.
     if (mpCharacter && rkViewInfo.ShowFlags.HasFlag(EShowFlag::Skeletons))
     {
         CSkeleton *pSkel = mpCharacter->Character(mActiveCharSet)->pSkeleton;
@@ -103,6 +119,46 @@ SRayIntersection CCharacterNode::RayNodeIntersectTest(const CRay& rkRay, uint32
         }
     }
 
+    // Check for mesh under ray, using the posed mesh if the character is animated
+    CModel *pModel = (mpCharacter ? mpCharacter->Character(mActiveCharSet)->pModel : nullptr);
+
+    if (pModel && rkViewInfo.ShowFlags.HasFlag(EShowFlag::ObjectGeometry))
+    {
+        CRay TransformedRay = rkRay.Transformed(Transform().Inverse());
+        FRenderOptions Options = rkViewInfo.pRenderer->RenderOptions();
+        bool AllowBackfaces = ((Options & ERenderOption::EnableBackfaceCull) == 0);
+        std::pair<bool,float> Result(false, 0.f);
+
+        if (IsAnimated())
+        {
+            UpdatePosedMesh();
+            Result = mPosedMesh.IntersectsRay(TransformedRay, AllowBackfaces);
+        }
+        else
+        {
+            for (uint32 iSurf = 0; iSurf < pModel->GetSurfaceCount(); iSurf++)
+            {
+                std::pair<bool,float> SurfResult = pModel->GetSurface(iSurf)->IntersectsRay(TransformedRay, AllowBackfaces);
+
+                if (SurfResult.first && (!Result.first || SurfResult.second < Result.second))
+                    Result = SurfResult;
+            }
+        }
+
+        if (Result.first)
+        {
+            CVector3f WorldHitPoint = Transform() * TransformedRay.PointOnRay(Result.second);
+
+            SRayIntersection Intersect;
+            Intersect.Hit = true;
+            Intersect.ComponentIndex = -1;
+            Intersect.Distance = Math::Distance(rkRay.Origin(), WorldHitPoint);
+            Intersect.HitPoint = WorldHitPoint;
+            Intersect.pNode = this;
+            return Intersect;
+        }
+    }
+
     return SRayIntersection();
 }
 
@@ -132,14 +188,18 @@ void CCharacterNode::SetActiveChar(uint32 CharIndex)
 {
     mActiveCharSet = CharIndex;
     ConditionalSetDirty();
+    InvalidatePosedMesh();
 
     if (mpCharacter)
     {
         CModel *pModel = mpCharacter->Character(CharIndex)->pModel;
         mTransformData.ResizeToSkeleton(mpCharacter->Character(CharIndex)->pSkeleton);
         mLocalAABox = pModel ? pModel->AABox() : CAABox::skZero;
+        mPosedMesh.SetModel(pModel);
         MarkTransformChanged();
     }
+    else
+        mPosedMesh.SetModel(nullptr);
 }
 
 void CCharacterNode::SetActiveAnim(uint32 AnimIndex)
@@ -158,3 +218,54 @@ void CCharacterNode::UpdateTransformData()
         mTransformDataDirty = false;
     }
 }
+
+int32 CCharacterNode::PoseTimeBucket() const
+{
+    return (int32) floorf(mAnimTime * skPoseBucketsPerSecond);
+}
+
+void CCharacterNode::UpdatePosedMesh()
+{
+    CAnimation *pAnim = CurrentAnim();
+    int32 TimeBucket = PoseTimeBucket();
+
+    if (!mPosedMesh.Model() || (pAnim == mpPosedAnim && TimeBucket == mPosedTimeBucket))
+        return;
+
+    UpdateTransformData();
+    mPosedMesh.Pose(mTransformData);
+    mpPosedAnim = pAnim;
+    mPosedTimeBucket = TimeBucket;
+
+    if (mPosedBoundsCache.size() >= skMaxCachedPoseBounds)
+        mPosedBoundsCache.clear();
+
+    mPosedBoundsCache[std::make_pair(pAnim, TimeBucket)] = mPosedMesh.AABox();
+}
+
+CAABox CCharacterNode::PosedAABox()
+{
+    CModel *pModel = mPosedMesh.Model();
+
+    if (!pModel)
+        return mLocalAABox;
+
+    if (!IsAnimated() || !pModel->IsSkinned())
+        return pModel->AABox();
+
+    // Only skin the mesh if we haven't already seen this pose
+    auto Find = mPosedBoundsCache.find(std::make_pair(CurrentAnim(), PoseTimeBucket()));
+
+    if (Find != mPosedBoundsCache.end())
+        return Find->second;
+
+    UpdatePosedMesh();
+    return mPosedMesh.AABox();
+}
+
+void CCharacterNode::InvalidatePosedMesh()
+{
+    mpPosedAnim = nullptr;
+    mPosedTimeBucket = -1;
+    mPosedBoundsCache.clear();
+}
@@ -3,7 +3,9 @@
 
 #include "CSceneNode.h"
 #include "Core/Render/CBoneTransformData.h"
+#include "Core/Render/CPosedMesh.h"
 #include "Core/Resource/Animation/CAnimSet.h"
+#include <map>
 
 class CCharacterNode : public CSceneNode
 {
@@ -16,6 +18,16 @@ class CCharacterNode : public CSceneNode
 
     mutable bool mTransformDataDirty;
 
+    // Skinned mesh for picking and culling. Poses are cached per animation and time bucket,
+    // so scrubbing or looping an animation doesn't need to re-skin the mesh for every frame.
+    CPosedMesh mPosedMesh;
+    CAnimation *mpPosedAnim;
+    int32 mPosedTimeBucket;
+    std::map<std::pair<CAnimation*, int32>, CAABox> mPosedBoundsCache;
+
+    static const float skPoseBucketsPerSecond;
+    static const uint32 skMaxCachedPoseBounds;
+
 public:
     explicit CCharacterNode(CScene *pScene, uint32 NodeID, CAnimSet *pChar = 0, CSceneNode *pParent = 0);
 
@@ -44,6 +56,10 @@ protected:
     inline void SetDirty()              { mTransformDataDirty = true; }
     inline void ConditionalSetDirty()   { if (IsAnimated()) SetDirty(); }
     void UpdateTransformData();
+    int32 PoseTimeBucket() const;
+    void UpdatePosedMesh();
+    CAABox PosedAABox();
+    void InvalidatePosedMesh();
 };
 
 #endif // CCHARACTERNODE_H
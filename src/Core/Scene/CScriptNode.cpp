@@ -496,23 +496,45 @@ void CScriptNode::PropertyModified(IProperty* pProp)
         }
     }
 
-    // Update other editor properties
+    // Update other editor properties. Only the transform properties affect the node transform;
+    // changes to anything else that can move the node (such as the display asset) update it themselves.
     CScriptTemplate *pTemplate = Template();
 
     if (pProp == pTemplate->NameProperty())
         SetName("[" + mpInstance->Template()->Name() + "] " + mpInstance->InstanceName());
 
     else if (pProp == pTemplate->PositionProperty() || pProp->Parent() == pTemplate->PositionProperty())
+    {
         mPosition = mpInstance->Position();
+        MarkTransformChanged();
+    }
 
     else if (pProp == pTemplate->RotationProperty() || pProp->Parent() == pTemplate->RotationProperty())
+    {
         mRotation = CQuaternion::FromEuler(mpInstance->Rotation());
+        MarkTransformChanged();
+    }
 
     else if (pProp == pTemplate->ScaleProperty() || pProp->Parent() == pTemplate->ScaleProperty())
+    {
         mScale = mpInstance->Scale();
+        MarkTransformChanged();
+    }
 
-    MarkTransformChanged();
-    SetLightLayerIndex(mpLightParameters->LightLayerIndex());
+    // Light layer index only needs updating if the property is part of the light parameters
+    CStructProperty *pLightParams = pTemplate->LightParametersProperty();
+
+    if (pLightParams && mpLightParameters)
+    {
+        for (IProperty *pParent = pProp; pParent; pParent = pParent->Parent())
+        {
+            if (pParent == pLightParams)
+            {
+                SetLightLayerIndex(mpLightParameters->LightLayerIndex());
+                break;
+            }
+        }
+    }
 
     // Notify attachments
     for (uint32 AttachIdx = 0; AttachIdx < mAttachments.size(); AttachIdx++)
@@ -535,6 +557,7 @@ void CScriptNode::UpdatePreviewVolume()
 {
     EVolumeShape Shape = mpInstance->VolumeShape();
     TResPtr<CModel> pVolumeModel = nullptr;
+    CModel *pOldVolumeModel = (mHasVolumePreview ? mpVolumePreviewNode->Model() : nullptr);
 
     switch (Shape)
     {
@@ -559,6 +582,10 @@ void CScriptNode::UpdatePreviewVolume()
         mpVolumePreviewNode->SetModel(pVolumeModel);
         mpVolumePreviewNode->SetScale(mpInstance->VolumeScale());
     }
+
+    // The node's scale depends on whether it has a volume preview, so a shape change affects the transform and bounds
+    if (pVolumeModel != pOldVolumeModel)
+        MarkTransformChanged();
 }
 
 void CScriptNode::GeneratePosition()
@@ -9,6 +9,7 @@
 #include "Editor/WorldEditor/CWorldEditor.h"
 #include <Common/Macros.h>
 #include <Common/CTimer.h>
+#include <Core/GameProject/CCookedBlobCache.h>
 #include <Core/GameProject/CGameProject.h>
 
 #include <QFuture>
@@ -200,11 +201,20 @@ bool CEditorApplication::CookPackageList(QList<CPackage*> PackageList)
         {
             Dialog.SetNumTasks(PackageList.size());
 
+            // Assets shared between packages only need to be compressed once
+            CCookedBlobCache BlobCache;
+
             for (int PkgIdx = 0; PkgIdx < PackageList.size() && !Dialog.ShouldCancel(); PkgIdx++)
             {
                 CPackage *pPkg = PackageList[PkgIdx];
                 Dialog.SetTask(PkgIdx, "Cooking " + pPkg->Name() + ".pak...");
-                pPkg->Cook(&Dialog);
+                pPkg->Cook(&Dialog, &BlobCache);
+            }
+
+            if (BlobCache.NumHits() > 0)
+            {
+                debugf("Reused shared compressed data %d times across %d packages; skipped reading %lld bytes and saved %.2fs of compression",
+                       BlobCache.NumHits(), PackageList.size(), BlobCache.BytesNotRead(), BlobCache.TimeSaved());
             }
         });
 
@@ -39,7 +39,7 @@ CExportGameDialog::CExportGameDialog(const QString& rkIsoPath, const QString& rk
     if (ValidateGame())
     {
         mBuildVer = FindBuildVersion();
-        mpExporter = new CGameExporter(mDiscType, mGame, mWiiFrontend, mRegion, mGameTitle, mGameID, mBuildVer);
+        mpExporter = new CGameExporter(mDiscType, mGame, mWiiFrontend, mRegion, mGameTitle, mGameID, mBuildVer, TO_TSTRING(rkIsoPath));
         InitUI(rkExportDir);
 
         TString IsoName = TO_TSTRING(rkIsoPath).GetFileName();
@@ -427,6 +427,8 @@ void CExportGameDialog::Export()
     TString StrExportDir = TO_TSTRING(ExportDir);
     StrExportDir.EnsureEndsWith('/');
 
+    mpExporter->SetStreamFromSourceDisc( mpUI->StreamFromSourceDiscCheckBox->isChecked() );
+
     CProgressDialog Dialog("Creating new game project", false, true, parentWidget());
     QFuture<bool> Future = QtConcurrent::run(mpExporter, &CGameExporter::Export, mpDisc, StrExportDir, &NameMap, &GameInfo, &Dialog);
     mExportSuccess = Dialog.WaitForResults(Future);
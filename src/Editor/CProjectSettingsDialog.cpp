@@ -8,6 +8,7 @@
 #include <Common/Macros.h>
 #include <Core/GameProject/CGameExporter.h>
 #include <Core/GameProject/COpeningBanner.h>
+#include <Core/GameProject/CResourceIterator.h>
 
 #include <nod/nod.hpp>
 
@@ -25,6 +26,7 @@ CProjectSettingsDialog::CProjectSettingsDialog(QWidget *pParent)
     mpUI->setupUi(this);
 
     connect(mpUI->GameNameLineEdit, SIGNAL(editingFinished()), this, SLOT(GameNameChanged()));
+    connect(mpUI->CookProfileComboBox, SIGNAL(activated(int)), this, SLOT(CookProfileChanged(int)));
     connect(mpUI->CookPackageButton, SIGNAL(clicked()), this, SLOT(CookPackage()));
     connect(mpUI->CookAllDirtyPackagesButton, SIGNAL(clicked(bool)), this, SLOT(CookAllDirtyPackages()));
     connect(mpUI->BuildIsoButton, SIGNAL(clicked(bool)), this, SLOT(BuildISO()));
@@ -63,6 +65,7 @@ void CProjectSettingsDialog::ActiveProjectChanged(CGameProject *pProj)
         TString BuildName = pProj->GameInfo()->GetBuildName(BuildVer, Region);
         mpUI->BuildLineEdit->setText( QString("%1 (%2)").arg(BuildVer).arg( TO_QSTRING(BuildName) ) );
         mpUI->RegionLineEdit->setText( TO_QSTRING(RegionName) );
+        mpUI->CookProfileComboBox->setCurrentIndex( (int) pProj->CookProfile() );
 
         // Banner info
         COpeningBanner Banner(pProj);
@@ -96,6 +99,37 @@ void CProjectSettingsDialog::GameNameChanged()
     }
 }
 
+void CProjectSettingsDialog::CookProfileChanged(int NewIndex)
+{
+    ECookProfile NewProfile = (ECookProfile) NewIndex;
+
+    if (mpProject && NewProfile != mpProject->CookProfile())
+    {
+        mpProject->SetCookProfile(NewProfile);
+        mpProject->Save();
+
+        // Areas compress their own data when they're cooked, so the ones we've cooked need to be recooked with the
+        // new settings. Untouched base game areas are copied into packages as they are.
+        CResourceStore *pStore = mpProject->ResourceStore();
+
+        for (TResourceIterator<EResourceType::Area> It(pStore); It; ++It)
+        {
+            if (It->HasFlag(EResEntryFlag::HasBeenModified))
+            {
+                It->SetDirty();
+                It->SaveMetadata();
+            }
+        }
+
+        pStore->ConditionalSaveStore();
+
+        for (uint32 iPkg = 0; iPkg < mpProject->NumPackages(); iPkg++)
+            mpProject->PackageByIndex(iPkg)->MarkDirty();
+
+        SetupPackagesList();
+    }
+}
+
 void CProjectSettingsDialog::SetupPackagesList()
 {
     mpUI->PackagesList->clear();
@@ -151,34 +185,58 @@ void CProjectSettingsDialog::BuildISO()
 
     if (!IsoPath.isEmpty())
     {
-        bool NeedsDiscMerge = pProj->IsWiiDeAsobu() || pProj->IsTrilogy();
+        bool NeedsDiscMerge = pProj->NeedsDiscMerge();
         std::unique_ptr<nod::DiscBase> pBaseDisc = nullptr;
 
         if (NeedsDiscMerge)
         {
-            FilterString += ";*.wbfs";
-            QString SourceIsoPath = UICommon::OpenFileDialog(this, "Select the original ISO", FilterString, DefaultPath);
-
-            if (SourceIsoPath.isEmpty())
-                return;
-
-            // Verify this ISO matches the original
+            TString GameID = pProj->GameID();
             bool IsWii;
-            pBaseDisc = nod::OpenDiscFromImage(*TO_TWIDESTRING(SourceIsoPath), IsWii);
 
-            if (!pBaseDisc || !IsWii)
+            // Try the disc the project was exported from first
+            TString SourceDiscPath = pProj->SourceDiscPath();
+
+            if (!SourceDiscPath.IsEmpty() && FileUtil::Exists(SourceDiscPath))
             {
-                UICommon::ErrorMsg(this, "The ISO provided is not a valid Wii ISO!");
-                return;
-            }
+                pBaseDisc = nod::OpenDiscFromImage(*SourceDiscPath.ToUTF16(), IsWii);
 
-            const nod::Header& rkHeader = pBaseDisc->getHeader();
-            TString GameID = pProj->GameID();
+                if (pBaseDisc && (IsWii != pProj->IsWiiBuild() || strncmp(*GameID, pBaseDisc->getHeader().m_gameID, 6) != 0))
+                    pBaseDisc = nullptr;
+            }
 
-            if (strncmp(*GameID, rkHeader.m_gameID, 6) != 0)
+            if (!pBaseDisc)
             {
-                UICommon::ErrorMsg(this, "The ISO provided doesn't match the project!");
-                return;
+                if (pProj->IsWiiBuild())
+                    FilterString += ";*.wbfs";
+
+                QString SourceIsoPath = UICommon::OpenFileDialog(this, "Select the original ISO", FilterString, DefaultPath);
+
+                if (SourceIsoPath.isEmpty())
+                    return;
+
+                // Verify this ISO matches the original
+                pBaseDisc = nod::OpenDiscFromImage(*TO_TWIDESTRING(SourceIsoPath), IsWii);
+
+                if (!pBaseDisc || IsWii != pProj->IsWiiBuild())
+                {
+                    UICommon::ErrorMsg(this, pProj->IsWiiBuild() ? "The ISO provided is not a valid Wii ISO!" : "The ISO provided is not a valid GameCube ISO!");
+                    return;
+                }
+
+                const nod::Header& rkHeader = pBaseDisc->getHeader();
+
+                if (strncmp(*GameID, rkHeader.m_gameID, 6) != 0)
+                {
+                    UICommon::ErrorMsg(this, "The ISO provided doesn't match the project!");
+                    return;
+                }
+
+                // Remember the new location so the user doesn't need to select it again
+                if (!pProj->SourceDiscPath().IsEmpty())
+                {
+                    pProj->SetSourceDiscPath(TO_TSTRING(SourceIsoPath));
+                    pProj->Save();
+                }
             }
         }
 
@@ -195,7 +253,7 @@ void CProjectSettingsDialog::BuildISO()
             }
             else
             {
-                QFuture<bool> Future = QtConcurrent::run(pProj, &CGameProject::MergeISO, TO_TSTRING(IsoPath), (nod::DiscWii*) pBaseDisc.get(), &Dialog);
+                QFuture<bool> Future = QtConcurrent::run(pProj, &CGameProject::MergeISO, TO_TSTRING(IsoPath), pBaseDisc.get(), &Dialog);
                 Success = Dialog.WaitForResults(Future);
             }
 
@@ -27,6 +27,7 @@ public:
 public slots:
     void ActiveProjectChanged(CGameProject *pProj);
     void GameNameChanged();
+    void CookProfileChanged(int NewIndex);
     void SetupPackagesList();
     void CookPackage();
     void CookAllDirtyPackages();
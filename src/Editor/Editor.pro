@@ -198,7 +198,8 @@ HEADERS += \
     Widgets/CCheckableTreeWidgetItem.h \
     Widgets/CCheckableTreeWidget.h \
     Undo/IEditPropertyCommand.h \
-    Widgets/TEnumComboBox.h
+    Widgets/TEnumComboBox.h \
+    Undo/CUndoHistoryStore.h
 
 # Source Files
 SOURCES += \
@@ -273,7 +274,8 @@ SOURCES += \
     ResourceBrowser/CVirtualDirectoryTreeView.cpp \
     CPropertyNameValidator.cpp \
     CGeneratePropertyNamesDialog.cpp \
-    Undo/IEditPropertyCommand.cpp
+    Undo/IEditPropertyCommand.cpp \
+    Undo/CUndoHistoryStore.cpp
 
 # UI Files
 FORMS += \
@@ -522,6 +522,11 @@ void CPropertyModel::NotifyPropertyModified(class CScriptObject*, IProperty* pPr
     NotifyPropertyModified(IndexForProperty(pProp));
 }
 
+void CPropertyModel::NotifyPropertiesModified(const QList<class CScriptObject*>&, IProperty* pProp)
+{
+    NotifyPropertyModified(IndexForProperty(pProp));
+}
+
 void CPropertyModel::NotifyPropertyModified(const QModelIndex& rkIndex)
 {
     if (rowCount(rkIndex) != 0)
@@ -61,6 +61,7 @@ public:
 
 public slots:
     void NotifyPropertyModified(class CScriptObject *pInst, IProperty *pProp);
+    void NotifyPropertiesModified(const QList<class CScriptObject*>& rkInstances, IProperty *pProp);
     void NotifyPropertyModified(const QModelIndex& rkIndex);
 
 signals:
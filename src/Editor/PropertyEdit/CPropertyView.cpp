@@ -89,6 +89,7 @@ void CPropertyView::SetEditor(CWorldEditor *pEditor)
     mpEditor = pEditor;
     mpDelegate->SetEditor(pEditor);
     connect(mpEditor, SIGNAL(PropertyModified(CScriptObject*,IProperty*)), mpModel, SLOT(NotifyPropertyModified(CScriptObject*,IProperty*)));
+    connect(mpEditor, SIGNAL(PropertiesModified(QList<CScriptObject*>,IProperty*)), mpModel, SLOT(NotifyPropertiesModified(QList<CScriptObject*>,IProperty*)));
 }
 
 void CPropertyView::SetIntrinsicProperties(CStructRef InProperties)
@@ -264,6 +264,8 @@ void CResourceBrowser::CreateFilterCheckboxes()
             mTypeList << SResourceType { pType, pCheck };
         }
 
+        UpdateFilterCheckboxCounts();
+
         qSort(mTypeList.begin(), mTypeList.end(), [](const SResourceType& rkLeft, const SResourceType& rkRight) -> bool {
             return rkLeft.pTypeInfo->TypeName().ToUpper() < rkRight.pTypeInfo->TypeName().ToUpper();
         });
@@ -281,6 +283,16 @@ void CResourceBrowser::CreateFilterCheckboxes()
     mpFilterBoxesLayout->addSpacerItem(pSpacer);
 }
 
+void CResourceBrowser::UpdateFilterCheckboxCounts()
+{
+    if (!mpStore) return;
+
+    // Resource counts change whenever entries are added to or removed from the store, so this is
+    // called from the store and directory refresh handlers as well as when the checkboxes are created
+    foreach (const SResourceType& rkType, mTypeList)
+        rkType.pFilterCheckBox->setToolTip(QString("%1 resources").arg(mpStore->NumResourcesOfType(rkType.pTypeInfo->Type())));
+}
+
 bool CResourceBrowser::RenameResource(CResourceEntry *pEntry, const TString& rkNewName)
 {
     if (pEntry->Name() == rkNewName)
@@ -422,6 +434,7 @@ void CResourceBrowser::RefreshResources()
 void CResourceBrowser::RefreshDirectories()
 {
     mpDirectoryModel->SetRoot(mpStore->RootDirectory());
+    UpdateFilterCheckboxCounts();
 
     // Clear selection. This function is called when directories are created/deleted and our current selection might not be valid anymore
     QModelIndex RootIndex = mpDirectoryModel->index(0, 0, QModelIndex());
@@ -695,6 +708,10 @@ void CResourceBrowser::UpdateStore()
         mpUI->DirectoryTreeView->clearSelection();
         OnDirectorySelectionChanged(QModelIndex());
     }
+
+    // The store may have been rebuilt in place, so the counts need to be refreshed either way
+    else
+        UpdateFilterCheckboxCounts();
 }
 
 void CResourceBrowser::SetProjectStore()
@@ -59,6 +59,7 @@ public:
     void SelectResource(CResourceEntry *pEntry, bool ClearFiltersIfNecessary = false);
     void SelectDirectory(CVirtualDirectory *pDir);
     void CreateFilterCheckboxes();
+    void UpdateFilterCheckboxCounts();
 
     bool RenameResource(CResourceEntry *pEntry, const TString& rkNewName);
     bool RenameDirectory(CVirtualDirectory *pDir, const TString& rkNewName);
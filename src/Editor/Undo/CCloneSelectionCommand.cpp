@@ -1,11 +1,14 @@
 #include "CCloneSelectionCommand.h"
 #include "Editor/CSelectionIterator.h"
+#include <QHash>
+#include <QSet>
 
 CCloneSelectionCommand::CCloneSelectionCommand(INodeEditor *pEditor)
     : IUndoCommand("Clone")
     , mpEditor(qobject_cast<CWorldEditor*>(pEditor)) // todo: fix this! bad assumption! (clone handling code is in INodeEditor but active area is in CWorldEditor)
 {
     mOriginalSelection = mpEditor->Selection()->SelectedNodeList();
+    QSet<CScriptObject*> LinkedInstances;
 
     for (CSelectionIterator It(mpEditor->Selection()); It; ++It)
     {
@@ -21,8 +24,11 @@ CCloneSelectionCommand::CCloneSelectionCommand(INodeEditor *pEditor)
             {
                 CScriptNode *pNode = mpEditor->Scene()->NodeForInstance(pInst->Link(ELinkType::Outgoing, iLink)->Receiver());
 
-                if (!pNode->IsSelected())
+                if (!pNode->IsSelected() && !LinkedInstances.contains(pNode->Instance()))
+                {
+                    LinkedInstances << pNode->Instance();
                     mLinkedInstances << pNode->Instance();
+                }
             }
         }
     }
@@ -52,8 +58,7 @@ void CCloneSelectionCommand::redo()
 {
     QList<CSceneNode*> ToClone = mNodesToClone.DereferenceList();
     QList<CSceneNode*> ClonedNodes;
-    QList<uint32> ToCloneInstanceIDs;
-    QList<uint32> ClonedInstanceIDs;
+    QHash<uint32, uint32> ClonedInstanceIDs; // Maps source instance IDs to the IDs of their clones
 
     // Clone nodes
     foreach (CSceneNode *pNode, ToClone)
@@ -72,8 +77,7 @@ void CCloneSelectionCommand::redo()
         pCloneNode->SetRotation(pScript->LocalRotation());
         pCloneNode->SetScale(pScript->LocalScale());
 
-        ToCloneInstanceIDs << pInstance->InstanceID();
-        ClonedInstanceIDs << pCloneInst->InstanceID();
+        ClonedInstanceIDs.insert(pInstance->InstanceID(), pCloneInst->InstanceID());
         ClonedNodes << pCloneNode;
         mClonedNodes << pCloneNode;
         mpEditor->NotifyNodeSpawned(pCloneNode);
@@ -90,9 +94,7 @@ void CCloneSelectionCommand::redo()
             CLink *pSrcLink = pSrc->Link(ELinkType::Outgoing, iLink);
 
             // If we're cloning the receiver then target the cloned receiver instead of the original one.
-            uint32 ReceiverID = pSrcLink->ReceiverID();
-            if (ToCloneInstanceIDs.contains(ReceiverID))
-                ReceiverID = ClonedInstanceIDs[ToCloneInstanceIDs.indexOf(ReceiverID)];
+            uint32 ReceiverID = ClonedInstanceIDs.value(pSrcLink->ReceiverID(), pSrcLink->ReceiverID());
 
             CLink *pCloneLink = new CLink(pSrcLink->Area(), pSrcLink->State(), pSrcLink->Message(), pClone->InstanceID(), ReceiverID);
             pCloneLink->Sender()->AddLink(ELinkType::Outgoing, pCloneLink);
@@ -8,9 +8,21 @@ CDeleteSelectionCommand::CDeleteSelectionCommand(CWorldEditor *pEditor, const QS
     : IUndoCommand(rkCommandName)
     , mpEditor(pEditor)
 {
+    // Links and linked instances are gathered in a single pass over the selection, using hashed sets
+    // to skip duplicates, since deleting a large selection would otherwise take quadratic time
     QSet<CLink*> Links;
+    QSet<CScriptObject*> LinkedInstanceSet;
     QList<CScriptObject*> LinkedInstances;
 
+    auto AddLinkedInstance = [&](CScriptObject *pInst)
+    {
+        if (pInst && !LinkedInstanceSet.contains(pInst))
+        {
+            LinkedInstanceSet << pInst;
+            LinkedInstances << pInst;
+        }
+    };
+
     for (CSelectionIterator It(pEditor->Selection()); It; ++It)
     {
         mOldSelection << *It;
@@ -55,17 +67,17 @@ CDeleteSelectionCommand::CDeleteSelectionCommand(CWorldEditor *pEditor, const QS
                         mDeletedLinks << Link;
                         Links << pLink;
 
-                        if (!LinkedInstances.contains(pLink->Sender()))
-                            LinkedInstances << pLink->Sender();
-                        if (!LinkedInstances.contains(pLink->Receiver()))
-                            LinkedInstances << pLink->Receiver();
+                        AddLinkedInstance(pLink->Sender());
+                        AddLinkedInstance(pLink->Receiver());
                     }
                 }
             }
 
-            CVectorOutStream PropertyDataOut(&rNode.InstanceData, EEndian::BigEndian);
+            std::vector<char> InstanceData;
+            CVectorOutStream PropertyDataOut(&InstanceData, EEndian::BigEndian);
             CScriptCooker Cooker(pEditor->CurrentGame());
             Cooker.WriteInstance(PropertyDataOut, pInst);
+            rNode.InstanceData = CUndoHistoryStore::Instance()->Store(InstanceData);
         }
 
         else
@@ -73,21 +85,36 @@ CDeleteSelectionCommand::CDeleteSelectionCommand(CWorldEditor *pEditor, const QS
     }
 
     // Remove selected objects from the linked instances list.
-    LinkedInstances.removeAll(nullptr);
-
     foreach (CScriptObject *pInst, LinkedInstances)
     {
-        if (mpEditor->Scene()->NodeForInstance(pInst)->IsSelected())
-            LinkedInstances.removeOne(pInst);
+        if (!mpEditor->Scene()->NodeForInstance(pInst)->IsSelected())
+            mLinkedInstances << pInst;
     }
+}
 
-    mLinkedInstances = LinkedInstances;
+CDeleteSelectionCommand::~CDeleteSelectionCommand()
+{
+    for (int iNode = 0; iNode < mDeletedNodes.size(); iNode++)
+        CUndoHistoryStore::Instance()->Release(mDeletedNodes[iNode].InstanceData);
 }
 
 void CDeleteSelectionCommand::undo()
 {
     QList<CSceneNode*> NewNodes;
-    QList<uint32> NewInstanceIDs;
+    QSet<uint32> NewInstanceIDs;
+
+    // If any of the instance data was dropped to keep undo history within budget, we can't restore
+    // the deleted instances, so have the undo stack discard this command instead
+    QVector< std::vector<char> > InstanceData(mDeletedNodes.size());
+
+    for (int iNode = 0; iNode < mDeletedNodes.size(); iNode++)
+    {
+        if (!CUndoHistoryStore::Instance()->Load(mDeletedNodes[iNode].InstanceData, InstanceData[iNode]))
+        {
+            setObsolete(true);
+            return;
+        }
+    }
 
     // Spawn nodes
     for (int iNode = 0; iNode < mDeletedNodes.size(); iNode++)
@@ -95,7 +122,7 @@ void CDeleteSelectionCommand::undo()
         SDeletedNode& rNode = mDeletedNodes[iNode];
         mpEditor->NotifyNodeAboutToBeSpawned();
 
-        CMemoryInStream Mem(rNode.InstanceData.data(), rNode.InstanceData.size(), EEndian::BigEndian);
+        CMemoryInStream Mem(InstanceData[iNode].data(), InstanceData[iNode].size(), EEndian::BigEndian);
         CScriptObject *pInstance = CScriptLoader::LoadInstance(Mem, rNode.pArea, rNode.pLayer, rNode.pArea->Game(), true);
         CScriptNode *pNode = mpEditor->Scene()->CreateScriptNode(pInstance, rNode.NodeID);
         rNode.pArea->AddInstanceToArea(pInstance);
@@ -3,6 +3,7 @@
 
 #include "CDeleteLinksCommand.h"
 #include "IUndoCommand.h"
+#include "CUndoHistoryStore.h"
 #include "ObjReferences.h"
 #include "Editor/WorldEditor/CWorldEditor.h"
 #include <Core/Scene/CSceneNode.h>
@@ -29,7 +30,7 @@ class CDeleteSelectionCommand : public IUndoCommand
         CGameArea *pArea;
         CScriptLayer *pLayer;
         uint32 LayerIndex;
-        std::vector<char> InstanceData;
+        CUndoHistoryStore::THandle InstanceData;
     };
     QVector<SDeletedNode> mDeletedNodes;
 
@@ -48,6 +49,7 @@ class CDeleteSelectionCommand : public IUndoCommand
 
 public:
     CDeleteSelectionCommand(CWorldEditor *pEditor, const QString& rkCommandName = "Delete");
+    ~CDeleteSelectionCommand();
     void undo();
     void redo();
     bool AffectsCleanState() const { return true; }
@@ -73,8 +73,12 @@ public:
 
     void NotifyWorldEditor()
     {
+        mpEditor->BeginPropertyBatch();
+
         for (int InstanceIdx = 0; InstanceIdx < mInstances.size(); InstanceIdx++)
             mpEditor->OnPropertyModified(*mInstances[InstanceIdx], mpProperty);
+
+        mpEditor->EndPropertyBatch();
     }
 };
 
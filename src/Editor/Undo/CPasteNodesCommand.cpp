@@ -1,4 +1,6 @@
 #include "CPasteNodesCommand.h"
+#include <QHash>
+#include <QSet>
 
 CPasteNodesCommand::CPasteNodesCommand(CWorldEditor *pEditor, CScriptLayer *pLayer, CVector3f PastePoint)
     : IUndoCommand("Paste")
@@ -83,6 +85,17 @@ void CPasteNodesCommand::redo()
             PastedNodes << nullptr;
     }
 
+    // Map original instance IDs to their index in the mime data so link receivers can be looked up quickly
+    QHash<uint32, int> CopiedIndices;
+
+    for (int iNode = 0; iNode < rkNodes.size(); iNode++)
+    {
+        if (rkNodes[iNode].Type == ENodeType::Script)
+            CopiedIndices.insert(rkNodes[iNode].OriginalInstanceID, iNode);
+    }
+
+    QSet<CScriptObject*> LinkedInstances;
+
     // Fix links. This is how fixes are prioritized:
     // 1. If the link receiver has also been copied then redirect to the copied version.
     // 2. If we're pasting into the same area that this data was copied from and the receiver still exists, connect to original receiver.
@@ -96,7 +109,7 @@ void CPasteNodesCommand::redo()
             for (uint32 iLink = 0; iLink < pInstance->NumLinks(ELinkType::Outgoing); iLink++)
             {
                 CLink *pLink = pInstance->Link(ELinkType::Outgoing, iLink);
-                int Index = mpMimeData->IndexOfInstanceID(pLink->ReceiverID());
+                int Index = CopiedIndices.value(pLink->ReceiverID(), -1);
 
                 if (Index != -1)
                 {
@@ -119,7 +132,12 @@ void CPasteNodesCommand::redo()
                 {
                     CScriptObject *pReceiver = pLink->Receiver();
                     pReceiver->AddLink(ELinkType::Incoming, pLink);
-                    mLinkedInstances << pReceiver;
+
+                    if (!LinkedInstances.contains(pReceiver))
+                    {
+                        LinkedInstances << pReceiver;
+                        mLinkedInstances << pReceiver;
+                    }
                 }
             }
         }
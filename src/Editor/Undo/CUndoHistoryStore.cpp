@@ -0,0 +1,332 @@
+#include "CUndoHistoryStore.h"
+#include <Common/Log.h>
+#include <Common/Macros.h>
+#include <Core/CompressionUtil.h>
+#include <Core/CWorkerPool.h>
+#include <cstring>
+
+CUndoHistoryStore::CUndoHistoryStore()
+    : mNextHandle(1)
+    , mMemoryUsage(0)
+    , mBudget(skDefaultBudget)
+    , mChangeCount(0)
+    , mNumPendingJobs(0)
+    , mShuttingDown(false)
+{
+}
+
+CUndoHistoryStore::~CUndoHistoryStore()
+{
+    // Queued jobs skip their work once we're shutting down, but they still need to run before
+    // the store can go away. The worker pool always drains its queue, so this won't hang.
+    std::unique_lock<std::mutex> Lock(mMutex);
+    mShuttingDown = true;
+    mJobsFinished.wait(Lock, [this]() { return mNumPendingJobs == 0; });
+}
+
+bool CUndoHistoryStore::LoadInternal(THandle Handle, std::vector<char>& rOut) const
+{
+    auto Find = mEntries.find(Handle);
+
+    if (Find == mEntries.end())
+        return false;
+
+    const SEntry& rkEntry = Find->second;
+    std::vector<char> Uncompressed;
+    const std::vector<char> *pkData = &rkEntry.Data;
+
+    if (rkEntry.Compressed)
+    {
+        Uncompressed.resize(rkEntry.UncompressedSize);
+        uint32 TotalOut;
+
+        if (!CompressionUtil::DecompressZlib((uint8*) rkEntry.Data.data(), rkEntry.Data.size(),
+                                             (uint8*) Uncompressed.data(), Uncompressed.size(), TotalOut))
+        {
+            errorf("Failed to decompress undo history entry %d", Handle);
+            return false;
+        }
+
+        pkData = &Uncompressed;
+    }
+
+    if (rkEntry.Base == skInvalidHandle)
+    {
+        rOut = *pkData;
+        return true;
+    }
+
+    std::vector<char> BaseData;
+
+    if (!LoadInternal(rkEntry.Base, BaseData))
+        return false;
+
+    ApplyDelta(BaseData, *pkData, rOut);
+    return true;
+}
+
+void CUndoHistoryStore::EvictInternal(THandle Handle)
+{
+    auto Find = mEntries.find(Handle);
+
+    if (Find == mEntries.end())
+        return;
+
+    mMemoryUsage -= Find->second.Data.size();
+    mEntries.erase(Find);
+    mChangeCount++;
+
+    // Deltas are always newer than their base, so only later entries need to be checked
+    std::vector<THandle> Dependents;
+
+    for (auto Iter = mEntries.upper_bound(Handle); Iter != mEntries.end(); Iter++)
+    {
+        if (Iter->second.Base == Handle)
+            Dependents.push_back(Iter->first);
+    }
+
+    for (uint32 DepIdx = 0; DepIdx < Dependents.size(); DepIdx++)
+        EvictInternal(Dependents[DepIdx]);
+}
+
+void CUndoHistoryStore::EnforceBudget(THandle Protect)
+{
+    // Drop the oldest entries until we're under budget. Entries from Protect onwards are still
+    // being saved by the command that's currently being pushed, so they're always kept.
+    while (mMemoryUsage > mBudget && !mEntries.empty() && mEntries.begin()->first < Protect)
+        EvictInternal(mEntries.begin()->first);
+}
+
+void CUndoHistoryStore::QueueColdEntries()
+{
+    if (mEntries.size() <= skNumHotEntries)
+        return;
+
+    auto Iter = mEntries.rbegin();
+    std::advance(Iter, skNumHotEntries);
+
+    // Everything older than the first entry that's already been handled has been handled too
+    for (; Iter != mEntries.rend(); Iter++)
+    {
+        SEntry& rEntry = Iter->second;
+
+        if (rEntry.Compressed || rEntry.CompressionQueued)
+            break;
+
+        rEntry.CompressionQueued = true;
+
+        if (rEntry.Data.size() >= skMinCompressSize)
+        {
+            THandle Handle = Iter->first;
+            mNumPendingJobs++;
+
+            CWorkerPool::Shared()->AddJob([this, Handle]()
+            {
+                CompressEntry(Handle);
+                FinishJob();
+            });
+        }
+    }
+}
+
+void CUndoHistoryStore::CompressEntry(THandle Handle)
+{
+    std::vector<char> Data;
+
+    {
+        std::lock_guard<std::mutex> Lock(mMutex);
+        auto Find = mEntries.find(Handle);
+        if (mShuttingDown || Find == mEntries.end() || Find->second.Compressed) return;
+        Data = Find->second.Data;
+    }
+
+    // Compress outside the lock so the editor isn't held up
+    std::vector<char> Compressed(Data.size() + (Data.size() / 8) + 64);
+    uint32 TotalOut = 0;
+
+    if (!CompressionUtil::CompressZlib((uint8*) Data.data(), Data.size(), (uint8*) Compressed.data(), Compressed.size(), TotalOut))
+        return;
+
+    // Not worth the cost of decompressing it later if it didn't get noticeably smaller
+    if (TotalOut >= Data.size() - (Data.size() / 8))
+        return;
+
+    Compressed.resize(TotalOut);
+    Compressed.shrink_to_fit();
+
+    std::lock_guard<std::mutex> Lock(mMutex);
+    auto Find = mEntries.find(Handle);
+
+    if (Find != mEntries.end() && !Find->second.Compressed)
+    {
+        SEntry& rEntry = Find->second;
+        mMemoryUsage -= rEntry.Data.size();
+        mMemoryUsage += Compressed.size();
+        rEntry.Data = std::move(Compressed);
+        rEntry.Compressed = true;
+        mChangeCount++;
+    }
+}
+
+void CUndoHistoryStore::FinishJob()
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    ASSERT(mNumPendingJobs > 0);
+    mNumPendingJobs--;
+
+    if (mNumPendingJobs == 0)
+        mJobsFinished.notify_all();
+}
+
+/** Delta format: the new data size, followed by runs of changed bytes (offset, length, bytes) */
+void CUndoHistoryStore::EncodeDelta(const std::vector<char>& kBase, const std::vector<char>& kData, std::vector<char>& rOut)
+{
+    uint32 NewSize = kData.size();
+    uint32 CommonSize = (kBase.size() < kData.size() ? kBase.size() : kData.size());
+
+    rOut.clear();
+    rOut.resize(4);
+    memcpy(rOut.data(), &NewSize, 4);
+
+    auto WriteRun = [&](uint32 Offset, uint32 Length)
+    {
+        uint32 Pos = rOut.size();
+        rOut.resize(Pos + 8 + Length);
+        memcpy(&rOut[Pos], &Offset, 4);
+        memcpy(&rOut[Pos + 4], &Length, 4);
+        memcpy(&rOut[Pos + 8], &kData[Offset], Length);
+    };
+
+    uint32 Idx = 0;
+
+    while (Idx < CommonSize)
+    {
+        if (kBase[Idx] == kData[Idx])
+        {
+            Idx++;
+            continue;
+        }
+
+        // Extend the run until we find enough unchanged bytes in a row to be worth splitting it
+        uint32 RunStart = Idx;
+        uint32 RunEnd = Idx + 1;
+        uint32 Scan = RunEnd;
+
+        while (Scan < CommonSize && Scan - RunEnd < skMinDeltaGap)
+        {
+            if (kBase[Scan] != kData[Scan])
+                RunEnd = Scan + 1;
+
+            Scan++;
+        }
+
+        WriteRun(RunStart, RunEnd - RunStart);
+        Idx = Scan;
+    }
+
+    if (NewSize > CommonSize)
+        WriteRun(CommonSize, NewSize - CommonSize);
+}
+
+void CUndoHistoryStore::ApplyDelta(const std::vector<char>& kBase, const std::vector<char>& kDelta, std::vector<char>& rOut)
+{
+    uint32 NewSize;
+    memcpy(&NewSize, kDelta.data(), 4);
+
+    uint32 CopySize = (kBase.size() < NewSize ? kBase.size() : NewSize);
+    rOut.assign(kBase.begin(), kBase.begin() + CopySize);
+    rOut.resize(NewSize);
+
+    uint32 Pos = 4;
+
+    while (Pos < kDelta.size())
+    {
+        uint32 Offset, Length;
+        memcpy(&Offset, &kDelta[Pos], 4);
+        memcpy(&Length, &kDelta[Pos + 4], 4);
+        memcpy(&rOut[Offset], &kDelta[Pos + 8], Length);
+        Pos += 8 + Length;
+    }
+}
+
+CUndoHistoryStore::THandle CUndoHistoryStore::Store(const std::vector<char>& kData, THandle Base /*= skInvalidHandle*/)
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+
+    SEntry Entry;
+    Entry.Base = skInvalidHandle;
+    Entry.Compressed = false;
+    Entry.CompressionQueued = false;
+
+    std::vector<char> BaseData;
+
+    if (Base != skInvalidHandle && LoadInternal(Base, BaseData))
+    {
+        EncodeDelta(BaseData, kData, Entry.Data);
+
+        if (Entry.Data.size() < kData.size())
+            Entry.Base = Base;
+    }
+
+    if (Entry.Base == skInvalidHandle)
+        Entry.Data = kData;
+
+    Entry.Data.shrink_to_fit();
+    Entry.UncompressedSize = Entry.Data.size();
+
+    THandle Handle = mNextHandle++;
+    mMemoryUsage += Entry.Data.size();
+    mEntries.emplace(Handle, std::move(Entry));
+    mChangeCount++;
+
+    EnforceBudget(Base != skInvalidHandle ? Base : Handle);
+    QueueColdEntries();
+    return Handle;
+}
+
+bool CUndoHistoryStore::Load(THandle Handle, std::vector<char>& rOut) const
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    return LoadInternal(Handle, rOut);
+}
+
+bool CUndoHistoryStore::IsValid(THandle Handle) const
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    return mEntries.find(Handle) != mEntries.end();
+}
+
+void CUndoHistoryStore::Release(THandle Handle)
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    EvictInternal(Handle);
+}
+
+void CUndoHistoryStore::SetBudget(uint64 Budget)
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    mBudget = Budget;
+    mChangeCount++;
+
+    // Always keep the most recent entry, since it may belong to a command that's still in progress
+    if (!mEntries.empty())
+        EnforceBudget(mEntries.rbegin()->first);
+}
+
+uint64 CUndoHistoryStore::Budget() const
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    return mBudget;
+}
+
+uint64 CUndoHistoryStore::MemoryUsage() const
+{
+    std::lock_guard<std::mutex> Lock(mMutex);
+    return mMemoryUsage;
+}
+
+CUndoHistoryStore* CUndoHistoryStore::Instance()
+{
+    static CUndoHistoryStore sStore;
+    return &sStore;
+}
@@ -0,0 +1,98 @@
+#ifndef CUNDOHISTORYSTORE_H
+#define CUNDOHISTORYSTORE_H
+
+#include <Common/BasicTypes.h>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/** CUndoHistoryStore: Shared storage for the data saved by undo commands.
+ *  Commands store their saved state here instead of holding onto it themselves. Data saved relative
+ *  to an earlier entry (such as the new value of a property edit vs. the old value) is stored as a
+ *  binary delta. Entries that are far enough back in the history are compressed on the worker pool.
+ *  When the total size goes over budget, the oldest entries are dropped; commands that lose their
+ *  data should mark themselves obsolete, so the undo stack discards them when they're reached.
+ */
+class CUndoHistoryStore
+{
+public:
+    typedef uint32 THandle;
+    static const THandle skInvalidHandle = 0;
+
+    /** Default memory budget for undo history, in bytes */
+    static const uint64 skDefaultBudget = 64 * 1024 * 1024;
+
+private:
+    struct SEntry
+    {
+        THandle Base;               // Entry this one is a delta against; skInvalidHandle if it's stored whole
+        std::vector<char> Data;     // Stored data; delta-encoded if Base is valid, then possibly compressed
+        uint32 UncompressedSize;    // Size of the stored data before compression
+        bool Compressed;
+        bool CompressionQueued;
+    };
+    std::map<THandle, SEntry> mEntries; // Ordered by age, since handles are assigned in increasing order
+    mutable std::mutex mMutex;
+
+    THandle mNextHandle;
+    uint64 mMemoryUsage;
+    uint64 mBudget;
+    std::atomic<uint32> mChangeCount;
+
+    // Compression jobs on the worker pool reference the store, so it waits for them on destruction
+    uint32 mNumPendingJobs;
+    bool mShuttingDown;
+    std::condition_variable mJobsFinished;
+
+    /** Number of most recent entries that are kept uncompressed, since they're the most likely to be needed */
+    static const uint32 skNumHotEntries = 32;
+
+    /** Entries smaller than this aren't worth compressing */
+    static const uint32 skMinCompressSize = 256;
+
+    /** Runs of unchanged bytes shorter than this are folded into the surrounding delta runs */
+    static const uint32 skMinDeltaGap = 8;
+
+    CUndoHistoryStore();
+    ~CUndoHistoryStore();
+    bool LoadInternal(THandle Handle, std::vector<char>& rOut) const;
+    void EvictInternal(THandle Handle);
+    void EnforceBudget(THandle Protect);
+    void QueueColdEntries();
+    void CompressEntry(THandle Handle);
+    void FinishJob();
+
+    static void EncodeDelta(const std::vector<char>& kBase, const std::vector<char>& kData, std::vector<char>& rOut);
+    static void ApplyDelta(const std::vector<char>& kBase, const std::vector<char>& kDelta, std::vector<char>& rOut);
+
+public:
+    /** Store data. If a base entry is provided, the data is stored as a delta against it. */
+    THandle Store(const std::vector<char>& kData, THandle Base = skInvalidHandle);
+
+    /** Retrieve stored data. Returns false if the entry has been dropped to stay within budget. */
+    bool Load(THandle Handle, std::vector<char>& rOut) const;
+
+    /** Returns whether the entry still exists */
+    bool IsValid(THandle Handle) const;
+
+    /** Release an entry. Entries stored as deltas against it are released as well. */
+    void Release(THandle Handle);
+
+    /** Memory budget; setting a lower budget drops old entries immediately */
+    void SetBudget(uint64 Budget);
+    uint64 Budget() const;
+
+    /** Number of bytes currently used by stored entries */
+    uint64 MemoryUsage() const;
+
+    /** Incremented whenever memory usage changes, including from background compression.
+     *  UI can poll this to tell when usage needs to be redisplayed. */
+    inline uint32 ChangeCount() const { return mChangeCount.load(); }
+
+    /** Store shared by all undo stacks in the editor */
+    static CUndoHistoryStore* Instance();
+};
+
+#endif // CUNDOHISTORYSTORE_H
@@ -1,4 +1,5 @@
 #include "IEditPropertyCommand.h"
+#include <Common/Log.h>
 
 /** Save the current state of the object properties to the given data buffer */
 void IEditPropertyCommand::SaveObjectStateToArray(std::vector<char>& rVector)
@@ -29,11 +30,29 @@ void IEditPropertyCommand::RestoreObjectStateFromArray(std::vector<char>& rArray
     }
 }
 
+/** Restore the state of the object properties from the undo history store */
+void IEditPropertyCommand::RestoreObjectState(CUndoHistoryStore::THandle Handle)
+{
+    std::vector<char> Data;
+
+    if (CUndoHistoryStore::Instance()->Load(Handle, Data))
+    {
+        RestoreObjectStateFromArray(Data);
+    }
+    else
+    {
+        // Our data was dropped to keep undo history within budget; have the undo stack discard this command
+        setObsolete(true);
+    }
+}
+
 IEditPropertyCommand::IEditPropertyCommand(
         IProperty* pProperty,
         const QString& rkCommandName /*= "Edit Property"*/
         )
     : IUndoCommand(rkCommandName)
+    , mOldData(CUndoHistoryStore::skInvalidHandle)
+    , mNewData(CUndoHistoryStore::skInvalidHandle)
     , mpProperty(pProperty)
     , mSavedOldData(false)
     , mSavedNewData(false)
@@ -41,22 +60,49 @@ IEditPropertyCommand::IEditPropertyCommand(
     ASSERT(mpProperty);
 }
 
+IEditPropertyCommand::~IEditPropertyCommand()
+{
+    // Releasing the old data releases the new data too, since it's stored as a delta
+    CUndoHistoryStore::Instance()->Release(mNewData);
+    CUndoHistoryStore::Instance()->Release(mOldData);
+}
+
 void IEditPropertyCommand::SaveOldData()
 {
-    SaveObjectStateToArray(mOldData);
+    std::vector<char> Data;
+    SaveObjectStateToArray(Data);
+
+    CUndoHistoryStore::Instance()->Release(mNewData);
+    CUndoHistoryStore::Instance()->Release(mOldData);
+    mOldData = CUndoHistoryStore::Instance()->Store(Data);
+    mNewData = CUndoHistoryStore::skInvalidHandle;
     mSavedOldData = true;
 }
 
 void IEditPropertyCommand::SaveNewData()
 {
-    SaveObjectStateToArray(mNewData);
+    std::vector<char> Data;
+    SaveObjectStateToArray(Data);
+
+    CUndoHistoryStore::Instance()->Release(mNewData);
+    mNewData = CUndoHistoryStore::Instance()->Store(Data, mOldData);
     mSavedNewData = true;
 }
 
 bool IEditPropertyCommand::IsNewDataDifferent()
 {
-    if (mOldData.size() != mNewData.size()) return true;
-    return memcmp(mOldData.data(), mNewData.data(), mNewData.size()) != 0;
+    std::vector<char> OldData, NewData;
+
+    // If either state can't be loaded, we can't tell whether anything changed. Assume it did, so
+    // the edit still gets pushed and marks the project dirty.
+    if (!CUndoHistoryStore::Instance()->Load(mOldData, OldData) ||
+        !CUndoHistoryStore::Instance()->Load(mNewData, NewData))
+    {
+        warnf("Failed to load saved property data for %s; assuming it changed", *mpProperty->Name());
+        return true;
+    }
+
+    return OldData != NewData;
 }
 
 void IEditPropertyCommand::SetEditComplete(bool IsComplete)
@@ -92,8 +138,14 @@ bool IEditPropertyCommand::mergeWith(const QUndoCommand *pkOther)
                         return false;
                 }
 
-                // Match
-                mNewData = pkCmd->mNewData;
+                // Match. The other command is deleted after merging, so take a copy of its data.
+                std::vector<char> NewData;
+
+                if (!CUndoHistoryStore::Instance()->Load(pkCmd->mNewData, NewData))
+                    return false;
+
+                CUndoHistoryStore::Instance()->Release(mNewData);
+                mNewData = CUndoHistoryStore::Instance()->Store(NewData, mOldData);
                 mCommandEnded = pkCmd->mCommandEnded;
                 return true;
             }
@@ -106,14 +158,14 @@ bool IEditPropertyCommand::mergeWith(const QUndoCommand *pkOther)
 void IEditPropertyCommand::undo()
 {
     ASSERT(mSavedOldData && mSavedNewData);
-    RestoreObjectStateFromArray(mOldData);
+    RestoreObjectState(mOldData);
     mCommandEnded = true;
 }
 
 void IEditPropertyCommand::redo()
 {
     ASSERT(mSavedOldData && mSavedNewData);
-    RestoreObjectStateFromArray(mNewData);
+    RestoreObjectState(mNewData);
 }
 
 bool IEditPropertyCommand::AffectsCleanState() const
@@ -3,14 +3,15 @@
 
 #include "IUndoCommand.h"
 #include "EUndoCommand.h"
+#include "CUndoHistoryStore.h"
 #include "Editor/PropertyEdit/CPropertyModel.h"
 
 class IEditPropertyCommand : public IUndoCommand
 {
 protected:
-    // Has to be std::vector for compatibility with CVectorOutStream
-    std::vector<char> mOldData;
-    std::vector<char> mNewData;
+    // Saved states live in the undo history store; the new state is stored as a delta against the old one
+    CUndoHistoryStore::THandle mOldData;
+    CUndoHistoryStore::THandle mNewData;
 
     IProperty* mpProperty;
     bool mCommandEnded;
@@ -23,11 +24,15 @@ protected:
     /** Restore the state of the object properties from the given data buffer */
     void RestoreObjectStateFromArray(std::vector<char>& rArray);
 
+    /** Restore the state of the object properties from the undo history store */
+    void RestoreObjectState(CUndoHistoryStore::THandle Handle);
+
 public:
     IEditPropertyCommand(
             IProperty* pProperty,
             const QString& rkCommandName = "Edit Property"
             );
+    ~IEditPropertyCommand();
 
     virtual void SaveOldData();
     virtual void SaveNewData();
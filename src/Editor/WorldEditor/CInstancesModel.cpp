@@ -4,7 +4,10 @@
 #include <Core/Resource/Script/NGameList.h>
 #include <Core/Scene/CScriptNode.h>
 #include <QApplication>
+#include <QHash>
 #include <QIcon>
+#include <QMap>
+#include <algorithm>
 
 /*
  * The tree has 3 levels:
@@ -35,17 +38,15 @@ CInstancesModel::CInstancesModel(CWorldEditor *pEditor, QObject *pParent)
     , mpCurrentGame(nullptr)
     , mModelType(EInstanceModelType::Layers)
     , mShowColumnEnabled(true)
-    , mChangingLayout(false)
 {
     mBaseItems << "Script";
 
     connect(gpEdApp, SIGNAL(ActiveProjectChanged(CGameProject*)), this, SLOT(OnActiveProjectChanged(CGameProject*)));
     connect(mpEditor, SIGNAL(MapChanged(CWorld*,CGameArea*)), this, SLOT(OnMapChange()));
-    connect(mpEditor, SIGNAL(NodeAboutToBeSpawned()), this, SLOT(NodeAboutToBeCreated()));
     connect(mpEditor, SIGNAL(NodeSpawned(CSceneNode*)), this, SLOT(NodeCreated(CSceneNode*)));
     connect(mpEditor, SIGNAL(NodeAboutToBeDeleted(CSceneNode*)), this, SLOT(NodeAboutToBeDeleted(CSceneNode*)));
-    connect(mpEditor, SIGNAL(NodeDeleted()), this, SLOT(NodeDeleted()));
     connect(mpEditor, SIGNAL(PropertyModified(CScriptObject*,IProperty*)), this, SLOT(PropertyModified(CScriptObject*,IProperty*)));
+    connect(mpEditor, SIGNAL(PropertiesModified(QList<CScriptObject*>,IProperty*)), this, SLOT(PropertiesModified(QList<CScriptObject*>,IProperty*)));
     connect(mpEditor, SIGNAL(InstancesLayerAboutToChange()), this, SLOT(InstancesLayerPreChange()));
     connect(mpEditor, SIGNAL(InstancesLayerChanged(QList<CScriptNode*>)), this, SLOT(InstancesLayerPostChange(QList<CScriptNode*>)));
 }
@@ -96,26 +97,12 @@ QModelIndex CInstancesModel::index(int Row, int Column, const QModelIndex& rkPar
         // Object
         if (RootRow == 0)
         {
-            if (mModelType == EInstanceModelType::Layers)
-            {
-                CScriptLayer *pLayer = mpArea->ScriptLayer(rkParent.row());
-                if ((uint32) Row >= pLayer->NumInstances())
-                    return QModelIndex();
-                else
-                    return createIndex(Row, Column, (*pLayer)[Row]);
-            }
+            const QVector<CScriptObject*>& rkInstances = mGroupInstances[rkParent.row()];
 
-            else if (mModelType == EInstanceModelType::Types)
-            {
-                const std::list<CScriptObject*>& list = mTemplateList[rkParent.row()]->ObjectList();
-                if ((uint32) Row >= list.size())
-                    return QModelIndex();
-                else
-                {
-                    auto it = std::next(list.begin(), Row);
-                    return createIndex(Row, Column, *it);
-                }
-            }
+            if (Row >= rkInstances.size())
+                return QModelIndex();
+            else
+                return createIndex(Row, Column, rkInstances[Row]);
         }
 
         // todo: implement getters for other types
@@ -143,28 +130,10 @@ QModelIndex CInstancesModel::parent(const QModelIndex& rkChild) const
     else if (Type == EIndexType::Instance)
     {
         CScriptObject *pObj = static_cast<CScriptObject*>   (rkChild.internalPointer());
+        int Row = GroupRow(pObj);
 
-        if (mModelType == EInstanceModelType::Layers)
-        {
-            CScriptLayer *pLayer = pObj->Layer();
-
-            for (uint32 iLyr = 0; iLyr < mpArea->NumScriptLayers(); iLyr++)
-            {
-                if (mpArea->ScriptLayer(iLyr) == pLayer)
-                    return createIndex(iLyr, 0, (iLyr << TYPES_ROW_INDEX_SHIFT) | 1);
-            }
-        }
-
-        else if (mModelType == EInstanceModelType::Types)
-        {
-            CScriptTemplate *pTemp = pObj->Template();
-
-            for (int iTemp = 0; iTemp < mTemplateList.size(); iTemp++)
-            {
-                if (mTemplateList[iTemp] == pTemp)
-                    return createIndex(iTemp, 0, (iTemp << TYPES_ROW_INDEX_SHIFT) | 1);
-            }
-        }
+        if (Row != -1)
+            return createIndex(Row, 0, (Row << TYPES_ROW_INDEX_SHIFT) | 1);
     }
 
     return QModelIndex();
@@ -183,12 +152,7 @@ int CInstancesModel::rowCount(const QModelIndex& rkParent) const
     {
         // Script Objects
         if (rkParent.row() == 0)
-        {
-            if (mModelType == EInstanceModelType::Layers)
-                return (mpArea ? mpArea->NumScriptLayers() : 0);
-            else
-                return mTemplateList.size();
-        }
+            return mGroupInstances.size();
         else
             return 0;
     }
@@ -197,10 +161,7 @@ int CInstancesModel::rowCount(const QModelIndex& rkParent) const
     else if (Type == EIndexType::ObjectType)
     {
         uint32 RowIndex = ((rkParent.internalId() & TYPES_ROW_INDEX_MASK) >> TYPES_ROW_INDEX_SHIFT);
-        if (mModelType == EInstanceModelType::Layers)
-            return (mpArea ? mpArea->ScriptLayer(RowIndex)->NumInstances() : 0);
-        else
-            return mTemplateList[RowIndex]->NumObjects();
+        return mGroupInstances[RowIndex].size();
     }
 
     else
@@ -324,7 +285,11 @@ QVariant CInstancesModel::data(const QModelIndex& rkIndex, int Role) const
 
 void CInstancesModel::SetModelType(EInstanceModelType Type)
 {
-    mModelType = Type;
+    if (mModelType != Type)
+    {
+        mModelType = Type;
+        GenerateList();
+    }
 }
 
 void CInstancesModel::SetShowColumnEnabled(bool Enabled)
@@ -362,141 +327,146 @@ CScriptObject* CInstancesModel::IndexObject(const QModelIndex& rkIndex) const
 // ************ PUBLIC SLOTS ************
 void CInstancesModel::OnActiveProjectChanged(CGameProject *pProj)
 {
-    if (mModelType == EInstanceModelType::Types)
-    {
-        if (pProj)
-            mpCurrentGame = NGameList::GetGameTemplate( pProj->Game() );
-        else
-            mpCurrentGame = nullptr;
-
-        GenerateList();
-    }
-}
+    // The game is tracked in both modes so switching to types doesn't need to look it up again
+    if (pProj)
+        mpCurrentGame = NGameList::GetGameTemplate( pProj->Game() );
+    else
+        mpCurrentGame = nullptr;
 
-void CInstancesModel::OnMapChange()
-{
     if (mModelType == EInstanceModelType::Types)
         GenerateList();
-
-    else
-    {
-        beginResetModel();
-        mpArea = mpEditor->ActiveArea();
-        endResetModel();
-    }
 }
 
-void CInstancesModel::NodeAboutToBeCreated()
+void CInstancesModel::OnMapChange()
 {
-    if (!mChangingLayout)
-    {
-        emit layoutAboutToBeChanged();
-        mChangingLayout = true;
-    }
+    mpArea = mpEditor->ActiveArea();
+    GenerateList();
 }
 
 void CInstancesModel::NodeCreated(CSceneNode *pNode)
 {
-    if (mChangingLayout)
+    if (pNode->NodeType() != ENodeType::Script)
+        return;
+
+    CScriptObject *pObj = static_cast<CScriptNode*>(pNode)->Instance();
+    QModelIndex ScriptRootIdx = index(0, 0, QModelIndex());
+    int GroupIdx = GroupRow(pObj);
+
+    // Templates get a row when their first instance is created, in alphabetical order
+    if (GroupIdx == -1)
     {
-        emit layoutChanged();
-        mChangingLayout = false;
+        if (mModelType != EInstanceModelType::Types)
+            return;
+
+        CScriptTemplate *pTemp = pObj->Template();
+        auto Iter = std::lower_bound(mTemplateList.begin(), mTemplateList.end(), pTemp, [](CScriptTemplate *pLeft, CScriptTemplate *pRight) -> bool {
+            return (pLeft->Name() < pRight->Name());
+        });
+        GroupIdx = Iter - mTemplateList.begin();
+
+        beginInsertRows(ScriptRootIdx, GroupIdx, GroupIdx);
+        mTemplateList.insert(GroupIdx, pTemp);
+        mGroupInstances.insert(GroupIdx, QVector<CScriptObject*>());
+        UpdateGroupRows(GroupIdx);
+        endInsertRows();
     }
 
+    // Find where the new instance goes. Templates are sorted by instance ID; layers match the layer's own order.
+    QVector<CScriptObject*>& rInstances = mGroupInstances[GroupIdx];
+    int Row;
+
     if (mModelType == EInstanceModelType::Types)
     {
-        if (pNode->NodeType() == ENodeType::Script)
-        {
-            CScriptNode *pScript = static_cast<CScriptNode*>(pNode);
-            CScriptObject *pObj = pScript->Instance();
-            pObj->Template()->SortObjects();
-
-            if (pObj->Template()->NumObjects() == 1)
-            {
-                QModelIndex ScriptRootIdx = index(0, 0, QModelIndex());
-                int NewIndex = 0;
-
-                for (; NewIndex < mTemplateList.size(); NewIndex++)
-                {
-                    if (mTemplateList[NewIndex]->Name() > pObj->Template()->Name())
-                        break;
-                }
-
-                beginInsertRows(ScriptRootIdx, NewIndex, NewIndex);
-                mTemplateList.insert(NewIndex, pObj->Template());
-                endInsertRows();
-            }
-        }
+        auto Iter = std::lower_bound(rInstances.begin(), rInstances.end(), pObj, [](CScriptObject *pLeft, CScriptObject *pRight) -> bool {
+            return (pLeft->InstanceID() < pRight->InstanceID());
+        });
+        Row = Iter - rInstances.begin();
     }
+    else
+    {
+        // New instances are usually appended to the end of the layer, so check that before searching it
+        CScriptLayer *pLayer = pObj->Layer();
+        uint32 NumInstances = pLayer->NumInstances();
+        Row = (NumInstances > 0 && pLayer->InstanceByIndex(NumInstances - 1) == pObj ? NumInstances - 1 : pObj->LayerIndex());
+        Row = qMin(Row, rInstances.size());
+    }
+
+    beginInsertRows(index(GroupIdx, 0, ScriptRootIdx), Row, Row);
+    rInstances.insert(Row, pObj);
+    endInsertRows();
 }
 
 void CInstancesModel::NodeAboutToBeDeleted(CSceneNode *pNode)
 {
-    if (pNode->NodeType() == ENodeType::Script)
-    {
-        if (mModelType == EInstanceModelType::Types)
-        {
-            CScriptNode *pScript = static_cast<CScriptNode*>(pNode);
-            CScriptObject *pObj = pScript->Instance();
+    if (pNode->NodeType() != ENodeType::Script)
+        return;
 
-            if (pObj->Template()->NumObjects() <= 1)
-            {
-                QModelIndex ScriptRootIdx = index(0, 0, QModelIndex());
-                int TempIdx = mTemplateList.indexOf(pObj->Template());
-                beginRemoveRows(ScriptRootIdx, TempIdx, TempIdx);
-                mTemplateList.removeOne(pObj->Template());
-                endRemoveRows();
-            }
+    CScriptObject *pObj = static_cast<CScriptNode*>(pNode)->Instance();
+    int GroupIdx = GroupRow(pObj);
+    int Row = (GroupIdx != -1 ? InstanceRow(pObj, GroupIdx) : -1);
 
-            else if (!mChangingLayout)
-            {
-                emit layoutAboutToBeChanged();
-                mChangingLayout = true;
-            }
-        }
+    if (Row == -1)
+        return;
 
-        else if (!mChangingLayout)
-        {
-            emit layoutAboutToBeChanged();
-            mChangingLayout = true;
-        }
-    }
-}
+    QModelIndex ScriptRootIdx = index(0, 0, QModelIndex());
+    QVector<CScriptObject*>& rInstances = mGroupInstances[GroupIdx];
 
-void CInstancesModel::NodeDeleted()
-{
-    if (mChangingLayout)
+    beginRemoveRows(index(GroupIdx, 0, ScriptRootIdx), Row, Row);
+    rInstances.remove(Row);
+    endRemoveRows();
+
+    // Templates with no instances left are removed from the list
+    if (mModelType == EInstanceModelType::Types && rInstances.isEmpty())
     {
-        emit layoutChanged();
-        mChangingLayout = false;
+        beginRemoveRows(ScriptRootIdx, GroupIdx, GroupIdx);
+        mGroupRows.remove(mTemplateList[GroupIdx]);
+        mTemplateList.removeAt(GroupIdx);
+        mGroupInstances.remove(GroupIdx);
+        UpdateGroupRows(GroupIdx);
+        endRemoveRows();
     }
 }
 
 void CInstancesModel::PropertyModified(CScriptObject *pInst, IProperty *pProp)
 {
-    if (pProp->Name() == "Name")
+    PropertiesModified(QList<CScriptObject*>() << pInst, pProp);
+}
+
+void CInstancesModel::PropertiesModified(const QList<CScriptObject*>& rkInstances, IProperty *pProp)
+{
+    if (pProp->Name() != "Name")
+        return;
+
+    // Find the range of modified rows under each parent so each parent only needs one dataChanged signal
+    QMap<int, QPair<int,int>> RowRanges;
+
+    foreach (CScriptObject *pInst, rkInstances)
     {
-        QModelIndex ScriptRoot = index(0, 0, QModelIndex());
+        int ParentRow = GroupRow(pInst);
+        int Row = (ParentRow != -1 ? InstanceRow(pInst, ParentRow) : -1);
 
-        if (mModelType == EInstanceModelType::Layers)
-        {
-            uint32 Index = pInst->Layer()->AreaIndex();
-            QModelIndex LayerIndex = index(Index, 0, ScriptRoot);
-            QModelIndex InstIndex = index(pInst->LayerIndex(), 0, LayerIndex);
-            emit dataChanged(InstIndex, InstIndex);
-        }
+        if (Row == -1)
+            continue;
+
+        auto Find = RowRanges.find(ParentRow);
+
+        if (Find == RowRanges.end())
+            RowRanges.insert(ParentRow, QPair<int,int>(Row, Row));
 
         else
         {
-            uint32 Index = mTemplateList.indexOf(pInst->Template());
-            QModelIndex TempIndex = index(Index, 0, ScriptRoot);
-
-            QList<CScriptObject*> InstList = QList<CScriptObject*>::fromStdList(pInst->Template()->ObjectList());
-            uint32 InstIdx = InstList.indexOf(pInst);
-            QModelIndex InstIndex = index(InstIdx, 0, TempIndex);
-            emit dataChanged(InstIndex, InstIndex);
+            Find.value().first = qMin(Find.value().first, Row);
+            Find.value().second = qMax(Find.value().second, Row);
         }
     }
+
+    QModelIndex ScriptRoot = index(0, 0, QModelIndex());
+
+    for (auto It = RowRanges.begin(); It != RowRanges.end(); It++)
+    {
+        QModelIndex ParentIndex = index(It.key(), 0, ScriptRoot);
+        emit dataChanged(index(It.value().first, 0, ParentIndex), index(It.value().second, 0, ParentIndex));
+    }
 }
 
 void CInstancesModel::InstancesLayerPreChange()
@@ -509,33 +479,31 @@ void CInstancesModel::InstancesLayerPreChange()
 
 void CInstancesModel::InstancesLayerPostChange(const QList<CScriptNode*>& rkInstanceList)
 {
-    QList<CScriptObject*> InstanceList;
-    foreach (CScriptNode *pNode, rkInstanceList)
-        InstanceList << pNode->Instance();
-
-    QModelIndex ScriptIdx = index(0, 0, QModelIndex());
-
     // For types, just find the instances that have changed layers and emit dataChanged for column 1.
     if (mModelType == EInstanceModelType::Types)
     {
-        for (int iType = 0; iType < rowCount(ScriptIdx); iType++)
+        QModelIndex ScriptIdx = index(0, 0, QModelIndex());
+
+        foreach (CScriptNode *pNode, rkInstanceList)
         {
-            QModelIndex TypeIdx = index(iType, 0, ScriptIdx);
+            CScriptObject *pInst = pNode->Instance();
+            int TypeRow = GroupRow(pInst);
+            int InstRow = (TypeRow != -1 ? InstanceRow(pInst, TypeRow) : -1);
 
-            for (int iInst = 0; iInst < rowCount(TypeIdx); iInst++)
+            if (InstRow != -1)
             {
-                QModelIndex InstIdx = index(iInst, 1, TypeIdx);
-                CScriptObject *pInst = IndexObject(InstIdx);
-
-                if (InstanceList.contains(pInst))
-                    emit dataChanged(InstIdx, InstIdx);
+                QModelIndex InstIdx = index(InstRow, 1, index(TypeRow, 0, ScriptIdx));
+                emit dataChanged(InstIdx, InstIdx);
             }
         }
     }
 
-    // For layers we just need to emit layoutChanged() and done
+    // For layers, rows have moved between layers, so rebuild the layer contents and emit layoutChanged()
     else
+    {
+        RebuildGroups();
         emit layoutChanged();
+    }
 }
 
 // ************ STATIC ************
@@ -563,28 +531,108 @@ ENodeType CInstancesModel::IndexNodeType(const QModelIndex& rkIndex)
 }
 
 // ************ PRIVATE ************
-void CInstancesModel::GenerateList()
+void* CInstancesModel::GroupKey(CScriptObject *pInst) const
 {
-    beginResetModel();
+    if (mModelType == EInstanceModelType::Layers)
+        return pInst->Layer();
+    else
+        return pInst->Template();
+}
 
-    mTemplateList.clear();
+int CInstancesModel::GroupRow(CScriptObject *pInst) const
+{
+    return mGroupRows.value(GroupKey(pInst), -1);
+}
+
+int CInstancesModel::InstanceRow(CScriptObject *pInst, int GroupRow) const
+{
+    const QVector<CScriptObject*>& rkInstances = mGroupInstances[GroupRow];
+
+    if (mModelType == EInstanceModelType::Types)
+    {
+        auto Iter = std::lower_bound(rkInstances.begin(), rkInstances.end(), pInst, [](CScriptObject *pLeft, CScriptObject *pRight) -> bool {
+            return (pLeft->InstanceID() < pRight->InstanceID());
+        });
+
+        if (Iter != rkInstances.end() && *Iter == pInst)
+            return Iter - rkInstances.begin();
+    }
+
+    return rkInstances.indexOf(pInst);
+}
 
-    if (mpCurrentGame)
+void CInstancesModel::UpdateGroupRows(int FirstRow)
+{
+    for (int Row = FirstRow; Row < mGroupInstances.size(); Row++)
     {
-        uint32 NumTemplates = mpCurrentGame->NumScriptTemplates();
+        void *pKey = (mModelType == EInstanceModelType::Layers ? (void*) mpArea->ScriptLayer(Row) : (void*) mTemplateList[Row]);
+        mGroupRows[pKey] = Row;
+    }
+}
 
-        for (uint32 iTemp = 0; iTemp < NumTemplates; iTemp++)
+void CInstancesModel::RebuildGroups()
+{
+    mTemplateList.clear();
+    mGroupInstances.clear();
+    mGroupRows.clear();
+
+    if (mModelType == EInstanceModelType::Types)
+    {
+        if (mpCurrentGame)
         {
-            CScriptTemplate *pTemp = mpCurrentGame->TemplateByIndex(iTemp);
+            uint32 NumTemplates = mpCurrentGame->NumScriptTemplates();
+
+            for (uint32 iTemp = 0; iTemp < NumTemplates; iTemp++)
+            {
+                CScriptTemplate *pTemp = mpCurrentGame->TemplateByIndex(iTemp);
+
+                if (pTemp->NumObjects() > 0)
+                    mTemplateList << pTemp;
+            }
+
+            qSort(mTemplateList.begin(), mTemplateList.end(), [](CScriptTemplate *pLeft, CScriptTemplate *pRight) -> bool {
+                return (pLeft->Name() < pRight->Name());
+            });
+
+            mGroupInstances.resize(mTemplateList.size());
 
-            if (pTemp->NumObjects() > 0)
-                mTemplateList << pTemp;
+            for (int iTemp = 0; iTemp < mTemplateList.size(); iTemp++)
+            {
+                const std::list<CScriptObject*>& rkObjects = mTemplateList[iTemp]->ObjectList();
+                QVector<CScriptObject*>& rInstances = mGroupInstances[iTemp];
+                rInstances.reserve(rkObjects.size());
+
+                for (auto Iter = rkObjects.begin(); Iter != rkObjects.end(); Iter++)
+                    rInstances << *Iter;
+
+                std::sort(rInstances.begin(), rInstances.end(), [](CScriptObject *pLeft, CScriptObject *pRight) -> bool {
+                    return (pLeft->InstanceID() < pRight->InstanceID());
+                });
+            }
         }
+    }
 
-        qSort(mTemplateList.begin(), mTemplateList.end(), [](CScriptTemplate *pLeft, CScriptTemplate *pRight) -> bool {
-            return (pLeft->Name() < pRight->Name());
-        });
+    else if (mpArea)
+    {
+        mGroupInstances.resize(mpArea->NumScriptLayers());
+
+        for (uint32 iLyr = 0; iLyr < mpArea->NumScriptLayers(); iLyr++)
+        {
+            CScriptLayer *pLayer = mpArea->ScriptLayer(iLyr);
+            QVector<CScriptObject*>& rInstances = mGroupInstances[iLyr];
+            rInstances.reserve(pLayer->NumInstances());
+
+            for (uint32 iInst = 0; iInst < pLayer->NumInstances(); iInst++)
+                rInstances << pLayer->InstanceByIndex(iInst);
+        }
     }
 
+    UpdateGroupRows(0);
+}
+
+void CInstancesModel::GenerateList()
+{
+    beginResetModel();
+    RebuildGroups();
     endResetModel();
 }
@@ -7,7 +7,9 @@
 #include <Core/Scene/CSceneNode.h>
 
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QList>
+#include <QVector>
 
 class CInstancesModel : public QAbstractItemModel
 {
@@ -33,7 +35,12 @@ private:
     QList<CScriptTemplate*> mTemplateList;
     QStringList mBaseItems;
     bool mShowColumnEnabled;
-    bool mChangingLayout;
+
+    // Instances under each layer (in layer order) or template (in instance ID order), with a lookup from
+    // layer/template to row. These are kept in sync as nodes are created and deleted, so the model can
+    // report changes with exact row inserts/removes instead of rebuilding or re-laying out everything.
+    QVector<QVector<CScriptObject*>> mGroupInstances;
+    QHash<void*, int> mGroupRows;
 
 public:
     explicit CInstancesModel(CWorldEditor *pEditor, QObject *pParent = 0);
@@ -55,12 +62,11 @@ public slots:
     void OnActiveProjectChanged(CGameProject *pProj);
     void OnMapChange();
 
-    void NodeAboutToBeCreated();
     void NodeCreated(CSceneNode *pNode);
     void NodeAboutToBeDeleted(CSceneNode *pNode);
-    void NodeDeleted();
 
     void PropertyModified(CScriptObject *pInst, IProperty *pProp);
+    void PropertiesModified(const QList<CScriptObject*>& rkInstances, IProperty *pProp);
     void InstancesLayerPreChange();
     void InstancesLayerPostChange(const QList<CScriptNode*>& rkInstanceList);
 
@@ -69,6 +75,11 @@ public slots:
     static ENodeType IndexNodeType(const QModelIndex& rkIndex);
 
 private:
+    void* GroupKey(CScriptObject *pInst) const;
+    int GroupRow(CScriptObject *pInst) const;
+    int InstanceRow(CScriptObject *pInst, int GroupRow) const;
+    void UpdateGroupRows(int FirstRow);
+    void RebuildGroups();
     void GenerateList();
 };
 
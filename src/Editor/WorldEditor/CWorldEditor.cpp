@@ -42,6 +42,9 @@ CWorldEditor::CWorldEditor(QWidget *parent)
     , mIsMakingLink(false)
     , mpNewLinkSender(nullptr)
     , mpNewLinkReceiver(nullptr)
+    , mpUndoMemoryLabel(nullptr)
+    , mLastUndoStoreChange(0)
+    , mPropertyBatchDepth(0)
 {
     debugf("Creating World Editor");
     ui->setupUi(this);
@@ -123,6 +126,11 @@ CWorldEditor::CWorldEditor(QWidget *parent)
 
     mpCollisionDialog = new CCollisionRenderSettingsDialog(this, this);
 
+    // Undo history memory display
+    mpUndoMemoryLabel = new QLabel(this);
+    ui->statusbar->addPermanentWidget(mpUndoMemoryLabel);
+    UpdateUndoMemoryLabel();
+
     // "Open Recent" menu
     mpOpenRecentMenu = new QMenu(this);
     ui->ActionOpenRecent->setMenu(mpOpenRecentMenu);
@@ -358,6 +366,10 @@ void CWorldEditor::EditorTick(float)
 {
     // Update new link line
     UpdateNewLinkLine();
+
+    // Undo history entries are compressed in the background, so poll for changes in memory usage
+    if (CUndoHistoryStore::Instance()->ChangeCount() != mLastUndoStoreChange)
+        UpdateUndoMemoryLabel();
 }
 
 void CWorldEditor::NotifyNodeAboutToBeDeleted(CSceneNode *pNode)
@@ -584,21 +596,60 @@ void CWorldEditor::OnPropertyModified(CScriptObject* pObject, IProperty *pProp)
     CScriptNode *pScript = mScene.NodeForInstance(pObject);
 
     if (pScript)
-    {
         pScript->PropertyModified(pProp);
 
-        // If this is the name, update other parts of the UI to reflect the new value.
-        if ( pProp->Name() == "Name" )
-        {
-            UpdateStatusBar();
-            UpdateSelectionUI();
-        }
-        else if (pProp->Name() == "Position" ||
-                 pProp->Name() == "Rotation" ||
-                 pProp->Name() == "Scale")
+    if (mPropertyBatchDepth > 0)
+    {
+        auto Find = mBatchedInstances.find(pProp);
+
+        if (Find == mBatchedInstances.end())
         {
-            mpSelection->UpdateBounds();
+            mBatchedProperties << pProp;
+            Find = mBatchedInstances.insert(pProp, QList<CScriptObject*>());
         }
+
+        Find.value() << pObject;
+    }
+    else
+        FinishPropertyEdits(QList<CScriptObject*>() << pObject, pProp);
+}
+
+/** Open a property edit batch. Batches can be nested; updates are deferred until the outermost batch ends. */
+void CWorldEditor::BeginPropertyBatch()
+{
+    mPropertyBatchDepth++;
+}
+
+void CWorldEditor::EndPropertyBatch()
+{
+    ASSERT(mPropertyBatchDepth > 0);
+    mPropertyBatchDepth--;
+
+    if (mPropertyBatchDepth == 0)
+    {
+        QVector<IProperty*> Properties = mBatchedProperties;
+        QHash<IProperty*, QList<CScriptObject*>> Instances = mBatchedInstances;
+        mBatchedProperties.clear();
+        mBatchedInstances.clear();
+
+        foreach (IProperty *pProp, Properties)
+            FinishPropertyEdits(Instances[pProp], pProp);
+    }
+}
+
+void CWorldEditor::FinishPropertyEdits(const QList<CScriptObject*>& rkInstances, IProperty *pProp)
+{
+    // If this is the name, update other parts of the UI to reflect the new value.
+    if ( pProp->Name() == "Name" )
+    {
+        UpdateStatusBar();
+        UpdateSelectionUI();
+    }
+    else if (pProp->Name() == "Position" ||
+             pProp->Name() == "Rotation" ||
+             pProp->Name() == "Scale")
+    {
+        mpSelection->UpdateBounds();
     }
 
     // If this is a model/character, then we'll treat this as a modified selection. This is to make sure the selection bounds updates.
@@ -614,7 +665,10 @@ void CWorldEditor::OnPropertyModified(CScriptObject* pObject, IProperty *pProp)
         SelectionModified();
 
     // Emit signal so other widgets can react to the property change
-    emit PropertyModified(pObject, pProp);
+    if (rkInstances.size() == 1)
+        emit PropertyModified(rkInstances.front(), pProp);
+    else
+        emit PropertiesModified(rkInstances, pProp);
 }
 
 void CWorldEditor::SetSelectionActive(bool Active)
@@ -800,6 +854,15 @@ void CWorldEditor::UpdateStatusBar()
         ui->statusbar->showMessage(StatusText);
 }
 
+void CWorldEditor::UpdateUndoMemoryLabel()
+{
+    CUndoHistoryStore *pStore = CUndoHistoryStore::Instance();
+    mLastUndoStoreChange = pStore->ChangeCount();
+    double UsageMB = (double) pStore->MemoryUsage() / (1024.0 * 1024.0);
+    double BudgetMB = (double) pStore->Budget() / (1024.0 * 1024.0);
+    mpUndoMemoryLabel->setText( QString("Undo history: %1 / %2 MB").arg(UsageMB, 0, 'f', 1).arg(BudgetMB, 0, 'f', 0) );
+}
+
 void CWorldEditor::UpdateGizmoUI()
 {
     // Update transform XYZ spin boxes
@@ -1113,6 +1176,8 @@ void CWorldEditor::OnUnlinkClicked()
 
 void CWorldEditor::OnUndoStackIndexChanged()
 {
+    UpdateUndoMemoryLabel();
+
     // Check the commands that have been executed on the undo stack and find out whether any of them affect the clean state.
     // This is to prevent commands like select/deselect from altering the clean state.
     int CurrentIndex = mUndoStack.index();
@@ -26,6 +26,8 @@
 #include <QComboBox>
 #include <QDir>
 #include <QFile>
+#include <QHash>
+#include <QLabel>
 #include <QList>
 #include <QMainWindow>
 #include <QTimer>
@@ -76,6 +78,14 @@ class CWorldEditor : public INodeEditor
     CPoiMapSidebar *mpPoiMapSidebar;
 
     QAction *mpPoiMapAction;
+    QLabel *mpUndoMemoryLabel;
+    uint32 mLastUndoStoreChange;
+
+    // Property edit batching. While a batch is open, editor-wide updates for modified properties are
+    // deferred and then done once per property when the batch ends, instead of once per object.
+    int mPropertyBatchDepth;
+    QVector<IProperty*> mBatchedProperties;
+    QHash<IProperty*, QList<CScriptObject*>> mBatchedInstances;
 
 public:
     explicit CWorldEditor(QWidget *parent = 0);
@@ -126,6 +136,8 @@ public slots:
     void OnActiveProjectChanged(CGameProject *pProj);
     void OnLinksModified(const QList<CScriptObject*>& rkInstances);
     void OnPropertyModified(CScriptObject* pObject, IProperty *pProp);
+    void BeginPropertyBatch();
+    void EndPropertyBatch();
     void SetSelectionActive(bool Active);
     void SetSelectionInstanceNames(const QString& rkNewName, bool IsDone);
     void SetSelectionLayer(CScriptLayer *pLayer);
@@ -134,6 +146,7 @@ public slots:
     void UpdateOpenRecentActions();
     void UpdateWindowTitle();
     void UpdateStatusBar();
+    void UpdateUndoMemoryLabel();
     void UpdateGizmoUI();
     void UpdateSelectionUI();
     void UpdateCursor();
@@ -141,6 +154,7 @@ public slots:
 
 protected:
     QAction* AddEditModeButton(QIcon Icon, QString ToolTip, EWorldEditorMode Mode);
+    void FinishPropertyEdits(const QList<CScriptObject*>& rkInstances, IProperty *pProp);
     void SetSidebar(CWorldEditorSidebar *pSidebar);
     void GizmoModeChanged(CGizmo::EGizmoMode Mode);
 
@@ -191,6 +205,7 @@ signals:
     void InstancesLayerChanged(const QList<CScriptNode*>& rkInstanceList);
     void InstanceLinksModified(const QList<CScriptObject*>& rkInstances);
     void PropertyModified(CScriptObject *pInst, IProperty *pProp);
+    void PropertiesModified(const QList<CScriptObject*>& rkInstances, IProperty *pProp);
 };
 
 #endif // CWORLDEDITOR_H
@@ -7,6 +7,7 @@
 #include <QIcon>
 
 CWorldTreeModel::CWorldTreeModel(CWorldEditor *pEditor)
+    : mActiveWorldRow(-1)
 {
     connect(gpEdApp, SIGNAL(ActiveProjectChanged(CGameProject*)), this, SLOT(OnProjectChanged(CGameProject*)));
     connect(pEditor, SIGNAL(MapChanged(CWorld*,CGameArea*)), this, SLOT(OnMapChanged()));
@@ -216,6 +217,9 @@ void CWorldTreeModel::OnProjectChanged(CGameProject *pProj)
 {
     beginResetModel();
     mWorldList.clear();
+    mAreaRows.clear();
+    mOpenedAreaRows.clear();
+    mActiveWorldRow = -1;
 
     if (pProj)
     {
@@ -340,16 +344,58 @@ void CWorldTreeModel::OnProjectChanged(CGameProject *pProj)
 
     }
 
+    for (int iWorld = 0; iWorld < mWorldList.size(); iWorld++)
+    {
+        const QList<CResourceEntry*>& rkAreas = mWorldList[iWorld].Areas;
+
+        for (int iArea = 0; iArea < rkAreas.size(); iArea++)
+            mAreaRows.insert(rkAreas[iArea], QPair<int,int>(iWorld, iArea));
+    }
+
     endResetModel();
 }
 
 void CWorldTreeModel::OnMapChanged()
 {
-    // Flag all data as changed to ensure the font updates correctly based on which areas are loaded
-    // note we don't know which areas used to be loaded, so flagging those specific indices isn't an option
-    int MaxRow = rowCount(QModelIndex()) - 1;
+    // The font depends on which areas are loaded, which can only change for the new active area and areas
+    // that were opened previously, so only those rows and their worlds are flagged as changed.
+    CWorldEditor *pEditor = gpEdApp->WorldEditor();
+    CResourceEntry *pActiveEntry = nullptr;
+
+    if (gpEdApp->ActiveProject() && gpEdApp->ActiveProject()->Game() == EGame::DKCReturns)
+        pActiveEntry = (pEditor->ActiveWorld() ? pEditor->ActiveWorld()->Entry() : nullptr);
+    else
+        pActiveEntry = (pEditor->ActiveArea() ? pEditor->ActiveArea()->Entry() : nullptr);
+
+    int OldWorldRow = mActiveWorldRow;
+    mActiveWorldRow = -1;
+
+    if (pActiveEntry)
+    {
+        auto Find = mAreaRows.find(pActiveEntry);
+
+        if (Find != mAreaRows.end())
+        {
+            mOpenedAreaRows.insert(Find.value());
+            mActiveWorldRow = Find.value().first;
+        }
+    }
+
     int MaxCol = columnCount(QModelIndex()) - 1;
-    emit dataChanged(index(0, 0, QModelIndex()), index(MaxRow, MaxCol, QModelIndex()));
+    QSet<int> WorldRows;
+
+    foreach (const QPair<int,int>& rkRow, mOpenedAreaRows)
+    {
+        QModelIndex WorldIndex = index(rkRow.first, 0, QModelIndex());
+        emit dataChanged(index(rkRow.second, 0, WorldIndex), index(rkRow.second, MaxCol, WorldIndex));
+        WorldRows.insert(rkRow.first);
+    }
+
+    if (OldWorldRow != -1)          WorldRows.insert(OldWorldRow);
+    if (mActiveWorldRow != -1)      WorldRows.insert(mActiveWorldRow);
+
+    foreach (int WorldRow, WorldRows)
+        emit dataChanged(index(WorldRow, 0, QModelIndex()), index(WorldRow, MaxCol, QModelIndex()));
 }
 
 // ************ PROXY MODEL ************
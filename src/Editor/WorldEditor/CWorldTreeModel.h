@@ -3,6 +3,8 @@
 
 #include <Core/Resource/CWorld.h>
 #include <QAbstractItemModel>
+#include <QHash>
+#include <QSet>
 #include <QSortFilterProxyModel>
 class CWorldEditor;
 
@@ -24,6 +26,11 @@ class CWorldTreeModel : public QAbstractItemModel
     };
     QList<SWorldInfo> mWorldList;
 
+    // Row lookups used to refresh only the affected rows when the active map changes
+    QHash<CResourceEntry*, QPair<int,int>> mAreaRows;
+    QSet<QPair<int,int>> mOpenedAreaRows;
+    int mActiveWorldRow;
+
 public:
     CWorldTreeModel(CWorldEditor *pEditor);
 
@@ -66,6 +66,7 @@ void WEditorProperties::SyncToEditor(CWorldEditor *pEditor)
     connect(mpEditor, SIGNAL(LayersModified()), this, SLOT(OnLayersModified()));
     connect(mpEditor, SIGNAL(InstancesLayerChanged(QList<CScriptNode*>)), this, SLOT(OnInstancesLayerChanged(QList<CScriptNode*>)));
     connect(mpEditor, SIGNAL(PropertyModified(CScriptObject*,IProperty*)), this, SLOT(OnPropertyModified(CScriptObject*,IProperty*)));
+    connect(mpEditor, SIGNAL(PropertiesModified(QList<CScriptObject*>,IProperty*)), this, SLOT(OnPropertiesModified(QList<CScriptObject*>,IProperty*)));
 
     OnLayersModified();
 }
@@ -148,6 +149,18 @@ void WEditorProperties::OnPropertyModified(CScriptObject *pInstance, IProperty *
     }
 }
 
+void WEditorProperties::OnPropertiesModified(const QList<CScriptObject*>& rkInstances, IProperty *pProp)
+{
+    // Only the displayed instance matters here, so there's no need to update once per instance
+    if (mpDisplayNode && mpDisplayNode->NodeType() == ENodeType::Script)
+    {
+        CScriptObject *pDisplayInst = static_cast<CScriptNode*>(mpDisplayNode)->Instance();
+
+        if (rkInstances.contains(pDisplayInst))
+            OnPropertyModified(pDisplayInst, pProp);
+    }
+}
+
 void WEditorProperties::OnInstancesLayerChanged(const QList<CScriptNode*>& rkNodeList)
 {
     if (rkNodeList.contains((CScriptNode*) mpDisplayNode))
@@ -40,6 +40,7 @@ public:
 public slots:
     void OnSelectionModified();
     void OnPropertyModified(CScriptObject *pInst, IProperty *pProp);
+    void OnPropertiesModified(const QList<CScriptObject*>& rkInstances, IProperty *pProp);
     void OnInstancesLayerChanged(const QList<CScriptNode*>& rkNodeList);
     void OnLayersModified();
     void UpdatePropertyValues();